@@ -0,0 +1,140 @@
+#include "../src/cSpec.h"
+
+/**
+ * @brief Micro benchmarks for passing array assertions, from 1 KB up to
+ * BENCH_MAX_BYTES per array (1 GB by default, two arrays are allocated).
+ * Build with: cc -O2 bench/arrays.bench.c -o arrays.bench
+ */
+
+#ifndef BENCH_MAX_BYTES
+  #define BENCH_MAX_BYTES ((size_t)1 << 30)
+#endif
+
+static void bench_report(const char *name, size_t bytes, size_t elapsed) {
+  printf(
+    "%-24s %10zu KB %14.3f us %8.2f GB/s\n",
+    name,
+    bytes / 1024,
+    elapsed / 1000.0,
+    elapsed ? (2.0 * bytes) / elapsed : 0.0
+  );
+}
+
+/**
+ * @brief Runs a passing assertion enough times to cover ~256 MB of input
+ */
+#define bench_array_assertion(name, assertion, bytes)               \
+  do {                                                              \
+    size_t repeats = ((size_t)1 << 28) / (bytes) + 1;               \
+    size_t start   = cspec_timer();                                 \
+    for(size_t r = 0; r < repeats; r++) {                           \
+      _cspec_clear_assertion_data();                                \
+      assertion;                                                    \
+    }                                                               \
+    bench_report(name, (bytes), (cspec_timer() - start) / repeats); \
+  } while(0)
+
+module(B_arrays, {
+  describe("passing int array assertions", {
+    it("measures element by element and bulk comparisons", {
+      for(size_t bytes = 1024; bytes <= BENCH_MAX_BYTES; bytes *= 4) {
+        size_t len    = bytes / sizeof(int);
+        int *actual   = (int *)malloc(bytes);
+        int *expected = (int *)malloc(bytes);
+        if(actual == NULL || expected == NULL) {
+          free(actual);
+          free(expected);
+          break;
+        }
+        for(size_t i = 0; i < len; i++) {
+          actual[i]   = (int)i;
+          expected[i] = (int)i;
+        }
+
+        bench_array_assertion(
+          "element by element",
+          _cspec_assert_that_array(
+            actual,
+            expected,
+            len,
+            "%d",
+            _cspec_int_comparison,
+            _cspec_write_assert
+          ),
+          bytes
+        );
+        bench_array_assertion(
+          "bulk memcmp",
+          assert_that_int_array(actual equals to expected with array_size len),
+          bytes
+        );
+
+        free(actual);
+        free(expected);
+      }
+    });
+  });
+
+  describe("passing double array assertions", {
+    it("measures element by element and tolerance kernels", {
+      for(size_t bytes = 1024; bytes <= BENCH_MAX_BYTES; bytes *= 4) {
+        size_t len       = bytes / sizeof(double);
+        double *actual   = (double *)malloc(bytes);
+        double *expected = (double *)malloc(bytes);
+        if(actual == NULL || expected == NULL) {
+          free(actual);
+          free(expected);
+          break;
+        }
+        for(size_t i = 0; i < len; i++) {
+          actual[i]   = (double)i * 0.5 + 1.0;
+          expected[i] = actual[i] + 1e-13;
+        }
+
+        bench_array_assertion(
+          "element by element",
+          _cspec_assert_that_array(
+            actual,
+            expected,
+            len,
+            "%g",
+            _cspec_double_comparison,
+            _cspec_write_assert
+          ),
+          bytes
+        );
+        bench_array_assertion(
+          "absolute tolerance",
+          assert_that_double_array_within(
+            actual equals to expected with array_size len within
+              cspec_absolute_tolerance(1e-12)
+          ),
+          bytes
+        );
+        bench_array_assertion(
+          "relative tolerance",
+          assert_that_double_array_within(
+            actual equals to expected with array_size len within
+              cspec_relative_tolerance(1e-9)
+          ),
+          bytes
+        );
+        bench_array_assertion(
+          "ulp tolerance",
+          assert_that_double_array_within(
+            actual equals to expected with array_size len within
+              cspec_ulp_tolerance(1 << 20)
+          ),
+          bytes
+        );
+
+        free(actual);
+        free(expected);
+      }
+    });
+  });
+})
+
+int main(void) {
+  cspec_run_suite("failing", { B_arrays(); });
+}
@@ -0,0 +1,70 @@
+#include "../src/cSpec.h"
+
+/**
+ * @brief Micro benchmarks for the assertion hot paths.
+ * Build with: cc -O2 bench/assertions.bench.c -o assertions.bench
+ */
+
+#define BENCH_ITERATIONS 10000000
+
+/**
+ * @brief The previous assertion body that formatted both operands eagerly,
+ * kept here as the baseline the lazy path is measured against
+ */
+#define _bench_eager_assert_that(                                    \
+  actual, expected, format, comparison, output_function              \
+)                                                                    \
+  do {                                                               \
+    _cspec_string_addf(cspec->current_actual, format, (actual));     \
+    _cspec_string_addf(cspec->current_expected, format, (expected)); \
+    if(comparison(actual, expected)) {                               \
+      output_function();                                             \
+    }                                                                \
+  } while(0)
+
+static void _bench_eager_assert_that_int(int actual, int expected) {
+  _bench_eager_assert_that(
+    actual, expected, "%d", _cspec_int_comparison, _cspec_write_assert
+  );
+}
+
+static void bench_report(const char *name, size_t start, size_t end) {
+  printf(
+    "%-32s %8.2f ns/assertion\n",
+    name,
+    (double)(end - start) / BENCH_ITERATIONS
+  );
+}
+
+module(B_assertions, {
+  describe("passing typed assertions", {
+    it("measures eager formatting", {
+      size_t start = cspec_timer();
+      for(int i = 0; i < BENCH_ITERATIONS; i++) {
+        _cspec_clear_assertion_data();
+        _bench_eager_assert_that_int(i, i);
+      }
+      bench_report("assert_that_int (eager)", start, cspec_timer());
+    });
+
+    it("measures lazy formatting", {
+      size_t start = cspec_timer();
+      for(int i = 0; i < BENCH_ITERATIONS; i++) {
+        assert_that_int(i equals to i);
+      }
+      bench_report("assert_that_int (lazy)", start, cspec_timer());
+    });
+
+    it("measures lazy formatting on size_t", {
+      size_t start = cspec_timer();
+      for(size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        assert_that_size_t(i equals to i);
+      }
+      bench_report("assert_that_size_t (lazy)", start, cspec_timer());
+    });
+  });
+})
+
+int main(void) {
+  cspec_run_suite("failing", { B_assertions(); });
+}
@@ -0,0 +1,52 @@
+#include "../src/cSpec.h"
+
+/**
+ * @brief Wall time of a suite of 8 modules that each keep a core busy, to
+ * compare CSPEC_JOBS=1 against CSPEC_JOBS=0 (one per core). Pass
+ * -DCSPEC_THREAD_POOL -pthread to compare CSPEC_THREADS the same way.
+ * Build with: cc -O2 bench/parallel.bench.c -o parallel.bench
+ */
+
+#ifndef BENCH_SPINS
+  #define BENCH_SPINS 50000000
+#endif
+
+static void bench_spin(void) {
+  volatile size_t sink = 0;
+  size_t i;
+  for(i = 0; i < BENCH_SPINS; i++) {
+    sink += i;
+  }
+}
+
+#define BENCH_MODULE(name)                        \
+  module(name, {                                  \
+    describe("a module that keeps a core busy", { \
+      it("spins", { bench_spin(); });             \
+      it("spins again", { bench_spin(); });       \
+    });                                           \
+  })
+
+BENCH_MODULE(B_first)
+BENCH_MODULE(B_second)
+BENCH_MODULE(B_third)
+BENCH_MODULE(B_fourth)
+BENCH_MODULE(B_fifth)
+BENCH_MODULE(B_sixth)
+BENCH_MODULE(B_seventh)
+BENCH_MODULE(B_eighth)
+
+int main(void) {
+  size_t start = cspec_timer();
+  cspec_run_suite("failing", {
+    B_first();
+    B_second();
+    B_third();
+    B_fourth();
+    B_fifth();
+    B_sixth();
+    B_seventh();
+    B_eighth();
+  });
+  printf("%.2f ms of wall time\n", (cspec_timer() - start) / 1000000.0);
+}
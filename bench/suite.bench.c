@@ -0,0 +1,40 @@
+#include "../src/cSpec.h"
+
+/**
+ * @brief Measures the fixed cost of the runner itself on a generated suite
+ * of BENCH_TESTS empty `it` blocks nested inside describes and contexts.
+ * Build with: cc -O2 bench/suite.bench.c -o suite.bench
+ */
+
+#ifndef BENCH_TESTS
+  #define BENCH_TESTS 100000
+#endif
+
+#define BENCH_GROUPS 100
+
+module(B_generated, {
+  int group;
+
+  for(group = 0; group < BENCH_GROUPS; group++) {
+    describe("a generated describe", {
+      context("a generated context", {
+        int test;
+
+        for(test = 0; test < BENCH_TESTS / BENCH_GROUPS; test++) {
+          it("passes without assertions", {});
+        }
+      });
+    });
+  }
+})
+
+int main(void) {
+  /* Discovery and execution both happen inside of cspec_run_suite */
+  size_t start = cspec_timer();
+  cspec_run_suite("failing", { B_generated(); });
+  printf(
+    "%d tests, %.2f ns per it\n",
+    BENCH_TESTS,
+    (double)(cspec_timer() - start) / BENCH_TESTS
+  );
+}
@@ -29,11 +29,14 @@
 #ifndef __CSPEC_H_
 #define __CSPEC_H_
 
+#include <errno.h>  /* errno, ERANGE, EINTR */
+#include <float.h>  /* DBL_MAX */
+#include <limits.h> /* INT_MIN, LLONG_MIN */
 #include <stdarg.h> /* va_start, va_end, va_arg */
 #include <stddef.h> /* size_t, ptrdiff_t */
-#include <stdio.h>  /* printf, snprintf */
-#include <stdlib.h> /* malloc, realloc */
-#include <string.h> /* strlen, strncmp, memmove */
+#include <stdio.h>  /* printf, vsnprintf */
+#include <stdlib.h> /* malloc, realloc, getenv, strtoull */
+#include <string.h> /* strlen, strcmp, memcmp, memchr, memmove, memcpy */
 
 #if defined(_WIN32)
   #include <time.h>
@@ -60,6 +63,35 @@
   #include <time.h>
 #endif
 
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define CSPEC_HAS_FORK
+
+  #include <poll.h>      /* poll */
+  #include <signal.h>    /* signal, SIGPIPE */
+  #include <sys/types.h> /* pid_t, ssize_t, off_t */
+  #include <sys/wait.h>  /* waitpid */
+  #include <unistd.h>    /* fork, pipe, dup2, read, write, lseek, sysconf */
+
+  /* Strict ISO modes hide the POSIX declaration of fileno */
+  #if !defined(_POSIX_C_SOURCE) && !defined(__cplusplus)
+extern int fileno(FILE *stream);
+  #endif
+#endif
+
+/* Strict ISO modes hide kill, which stops a test that ran out of time */
+#if defined(CSPEC_HAS_FORK) && !defined(__STRICT_ANSI__) && \
+  !defined(CSPEC_HAS_SIGNALS)
+  #define CSPEC_HAS_SIGNALS
+#endif
+
+#if defined(CSPEC_THREAD_POOL)
+  #include <pthread.h> /* pthread_create, pthread_join */
+#endif
+
 /**
  * @desc: A cross platform timer function for profiling
  * @return The time in nanoseconds
@@ -102,6 +134,169 @@ static size_t cspec_timer(void) {
 #define _cspec_true  1
 #define _cspec_false 0
 
+/**
+ * @param CSPEC_PASSING -> Set for passing tests
+ * @param CSPEC_FAILING -> Set for failing tests
+ */
+#define CSPEC_PASSING _cspec_true
+#define CSPEC_FAILING _cspec_false
+
+/**
+ * @brief A bump allocator owning every framework string. Blocks are never
+ * returned one by one, the whole arena is rewound at the end of each `it`
+ * @param previous -> The chunk that filled up before this one
+ * @param size -> The number of bytes handed out from this chunk
+ * @param capacity -> The number of usable bytes in this chunk
+ */
+typedef struct _cspec_arena_chunk {
+  struct _cspec_arena_chunk *previous;
+  size_t size;
+  size_t capacity;
+} _cspec_arena_chunk;
+
+/**
+ * @param chunk -> The chunk new blocks are bumped from
+ * @param in_use -> Bytes handed out since the last reset
+ * @param high_water_mark -> The largest `in_use` seen during the run
+ * @param number_of_mallocs -> The number of chunks ever requested from malloc
+ */
+typedef struct {
+  _cspec_arena_chunk *chunk;
+  size_t in_use;
+  size_t high_water_mark;
+  size_t number_of_mallocs;
+} _cspec_arena;
+
+#ifndef CSPEC_ARENA_INITIAL_CAPACITY
+  #define CSPEC_ARENA_INITIAL_CAPACITY 16384
+#endif
+
+#define _cspec_arena_align(bytes) (((bytes) + 15) & ~(size_t)15)
+#define _cspec_arena_chunk_data(chunk) \
+  ((char *)(chunk) + _cspec_arena_align(sizeof(_cspec_arena_chunk)))
+#define _cspec_arena_chunk_top(chunk) \
+  (_cspec_arena_chunk_data(chunk) + (chunk)->size)
+
+static void _cspec_arena_push_chunk(_cspec_arena *arena, size_t capacity) {
+  _cspec_arena_chunk *chunk = (_cspec_arena_chunk *)malloc(
+    _cspec_arena_align(sizeof(_cspec_arena_chunk)) + capacity
+  );
+  chunk->previous = arena->chunk;
+  chunk->size     = 0;
+  chunk->capacity = capacity;
+  arena->chunk    = chunk;
+  arena->number_of_mallocs++;
+}
+
+static void _cspec_arena_initialize(_cspec_arena *arena) {
+  arena->chunk             = NULL;
+  arena->in_use            = 0;
+  arena->high_water_mark   = 0;
+  arena->number_of_mallocs = 0;
+  _cspec_arena_push_chunk(arena, CSPEC_ARENA_INITIAL_CAPACITY);
+}
+
+static void _cspec_arena_account(_cspec_arena *arena, size_t bytes) {
+  arena->chunk->size += bytes;
+  arena->in_use      += bytes;
+  if(arena->in_use > arena->high_water_mark) {
+    arena->high_water_mark = arena->in_use;
+  }
+}
+
+static void *_cspec_arena_alloc(_cspec_arena *arena, size_t bytes) {
+  void *block;
+  bytes = _cspec_arena_align(bytes);
+
+  if(arena->chunk->size + bytes > arena->chunk->capacity) {
+    size_t capacity = 2 * arena->chunk->capacity;
+    if(capacity < bytes) {
+      capacity = bytes;
+    }
+    _cspec_arena_push_chunk(arena, capacity);
+  }
+
+  block = _cspec_arena_chunk_top(arena->chunk);
+  _cspec_arena_account(arena, bytes);
+  return block;
+}
+
+/**
+ * @brief Grows a block in place when it is the last one handed out,
+ * otherwise bumps a new block and copies the old contents over. A last
+ * block that outgrows its chunk is given back as it moves to the next one
+ */
+static void *_cspec_arena_realloc(
+  _cspec_arena *arena, void *block, size_t old_bytes, size_t new_bytes
+) {
+  void *new_block;
+  old_bytes = _cspec_arena_align(old_bytes);
+  new_bytes = _cspec_arena_align(new_bytes);
+
+  if(block != NULL &&
+     (char *)block + old_bytes == _cspec_arena_chunk_top(arena->chunk)) {
+    if(arena->chunk->size - old_bytes + new_bytes <= arena->chunk->capacity) {
+      _cspec_arena_account(arena, new_bytes - old_bytes);
+      return block;
+    }
+    /* Nothing is bumped from the old chunk again before the next reset, so
+     * the contents stay in place for the copy */
+    arena->chunk->size -= old_bytes;
+    arena->in_use      -= old_bytes;
+  }
+
+  new_block = _cspec_arena_alloc(arena, new_bytes);
+  if(block != NULL) {
+    memcpy(new_block, block, old_bytes);
+  }
+  return new_block;
+}
+
+/**
+ * @brief Only the last block can be given back before a reset
+ */
+static void _cspec_arena_free(_cspec_arena *arena, void *block, size_t bytes) {
+  bytes = _cspec_arena_align(bytes);
+  if((char *)block + bytes == _cspec_arena_chunk_top(arena->chunk)) {
+    arena->chunk->size -= bytes;
+    arena->in_use      -= bytes;
+  }
+}
+
+/**
+ * @brief Rewinds the arena in O(1). If the run overflowed into extra chunks
+ * they get merged into a single chunk, so later resets stay malloc free
+ */
+static void _cspec_arena_reset(_cspec_arena *arena) {
+  if(arena->chunk->previous != NULL) {
+    size_t capacity = 0;
+    while(arena->chunk != NULL) {
+      _cspec_arena_chunk *previous = arena->chunk->previous;
+      capacity += arena->chunk->capacity;
+      free(arena->chunk);
+      arena->chunk = previous;
+    }
+    _cspec_arena_push_chunk(arena, capacity);
+  }
+  arena->chunk->size = 0;
+  arena->in_use      = 0;
+}
+
+#if defined(CSPEC_THREAD_POOL)
+/**
+ * @brief Gives every chunk back to malloc, for the arenas of pool threads
+ * that do not live as long as the suite does
+ */
+static void _cspec_arena_release(_cspec_arena *arena) {
+  while(arena->chunk != NULL) {
+    _cspec_arena_chunk *previous = arena->chunk->previous;
+    free(arena->chunk);
+    arena->chunk = previous;
+  }
+  arena->in_use = 0;
+}
+#endif
+
 typedef struct {
   size_t size;
   size_t capacity;
@@ -109,9 +304,10 @@ typedef struct {
 
 #define __cspec_vector_get_header(self)   ((_cspec_vector_header *)(self) - 1)
 #define __cspec_vector_selfptr_size(self) sizeof(*(self)) /* NOLINT */
-#define __cspec_vector_grow(self, n) \
-  (*(void **)&(self) =               \
-     __cspec_vector_growf((self), __cspec_vector_selfptr_size(self), (n), 0))
+#define __cspec_vector_grow(self, n)                                  \
+  (*(void **)&(self) = __cspec_vector_growf(                          \
+     &cspec->arena, (self), __cspec_vector_selfptr_size(self), (n), 0 \
+   ))
 #define __cspec_vector_maybegrow(self, n)                    \
   ((!(self) || __cspec_vector_get_header(self)->size + (n) > \
                  __cspec_vector_get_header(self)->capacity)  \
@@ -138,7 +334,11 @@ typedef struct {
 #define _cspec_vector_capacity(self) \
   ((self) ? (size_t)__cspec_vector_get_header(self)->capacity : 0)
 static void *__cspec_vector_growf(
-  void *self, size_t elemsize, size_t addlen, size_t min_cap
+  _cspec_arena *arena,
+  void *self,
+  size_t elemsize,
+  size_t addlen,
+  size_t min_cap
 ) {
   void *b;
   size_t min_len = _cspec_vector_size_signed(self) + addlen;
@@ -157,8 +357,12 @@ static void *__cspec_vector_growf(
     min_cap = 4;
   }
 
-  b = realloc(
+  b = _cspec_arena_realloc(
+    arena,
     (self) ? __cspec_vector_get_header(self) : 0,
+    (self) ? elemsize * _cspec_vector_capacity(self) +
+               sizeof(_cspec_vector_header)
+           : 0,
     elemsize * min_cap + sizeof(_cspec_vector_header)
   );
   b = (char *)b + sizeof(_cspec_vector_header);
@@ -171,9 +375,15 @@ static void *__cspec_vector_growf(
 
   return b;
 }
-#define _cspec_vector_free(self)                                              \
-  ((self) ? (*(void **)&(self) = realloc(__cspec_vector_get_header(self), 0)) \
-          : 0,                                                                \
+#define _cspec_vector_free(self)                                \
+  ((self) ? (_cspec_arena_free(                                 \
+               &cspec->arena,                                   \
+               __cspec_vector_get_header(self),                 \
+               sizeof(*(self)) * _cspec_vector_capacity(self) + \
+                 sizeof(_cspec_vector_header)                   \
+             ),                                                 \
+             0)                                                 \
+          : 0,                                                  \
    (self) = NULL)
 
 #define _cspec_string_add(self, other)                   \
@@ -201,25 +411,6 @@ static void *__cspec_vector_growf(
   } while(0)
 #define _cspec_string_ignore_last(self, len) \
   _cspec_string_shorten(self, _cspec_string_size(self) - len)
-static char *cspec_string_new(const char *initial_string) {
-  char *self = NULL;
-  _cspec_string_add(self, initial_string);
-  return self;
-}
-static void __cspec_string_internal_addf(char **self, const char *f, ...) {
-  signed int result = 0;
-  char buf[4096];
-  va_list args;
-
-  va_start(args, f)
-    ;
-    result = vsnprintf(buf, sizeof(buf), f, args);
-  va_end(args);
-
-  if(result >= 0) {
-    _cspec_string_add(*self, buf);
-  }
-}
 #define _cspec_string_addf(self, f, ...) \
   __cspec_string_internal_addf(&self, f, __VA_ARGS__)
 #define _cspec_string_delete(self) _cspec_string_shorten(self, 0)
@@ -246,77 +437,183 @@ static void __cspec_string_internal_addf(char **self, const char *f, ...) {
 #define cspec_fabs(value) ((value) < 0 ? -(value) : (value))
 
 /**
- * @brief A simple function definition for running test suites
- * @param type_of_tests -> passing|failing|skipped|all
+ * @brief Bits of the display filter, one per kind of test result
+ */
+#define CSPEC_DISPLAY_PASSING 1u
+#define CSPEC_DISPLAY_FAILING 2u
+#define CSPEC_DISPLAY_SKIPPED 4u
+#define CSPEC_DISPLAY_ALL \
+  (CSPEC_DISPLAY_PASSING | CSPEC_DISPLAY_FAILING | CSPEC_DISPLAY_SKIPPED)
+
+/**
+ * @brief Parses the type of tests once, so that reporting a result only
+ * has to test a single bit
+ * @param type_of_tests -> A comma separated list of passing|failing|skipped|all
+ * @return The display filter, or 0 when any of the types is unknown
+ */
+static unsigned int _cspec_parse_display_filter(const char *type_of_tests) {
+  unsigned int filter = 0;
+
+  while(*type_of_tests != '\0') {
+    size_t len = strcspn(type_of_tests, ",");
+
+    if(len == 7 && !strncmp(type_of_tests, "passing", 7)) {
+      filter |= CSPEC_DISPLAY_PASSING;
+    } else if(len == 7 && !strncmp(type_of_tests, "failing", 7)) {
+      filter |= CSPEC_DISPLAY_FAILING;
+    } else if(len == 7 && !strncmp(type_of_tests, "skipped", 7)) {
+      filter |= CSPEC_DISPLAY_SKIPPED;
+    } else if(len == 3 && !strncmp(type_of_tests, "all", 3)) {
+      filter |= CSPEC_DISPLAY_ALL;
+    } else {
+      return 0;
+    }
+
+    type_of_tests += len;
+    if(*type_of_tests == ',') {
+      type_of_tests++;
+    }
+  }
+
+  return filter;
+}
+
+/**
+ * @brief Discovers the block of modules and runs the selected tests
+ * @param display_filter -> CSPEC_DISPLAY_* bits of the results to print
  * @param ... -> The block of modules to run
  */
-#define cspec_run_suite(type_of_tests, ...)        \
-  do {                                             \
-    if(                                            \
-      strncmp((type_of_tests), "passing", 7) &&    \
-      strncmp((type_of_tests), "failing", 7) &&    \
-      strncmp((type_of_tests), "skipped", 7) &&    \
-      strncmp((type_of_tests), "all", 3)           \
-    ) {                                            \
-      printf(                                      \
-        "\n\033[1;31mInput a type of test to log " \
-        "passing|failing|skipped|all\033[0m\n\n"   \
-      );                                           \
-    } else {                                       \
-      _cspec_setup_test_data(type_of_tests);       \
-      __VA_ARGS__;                                 \
-      _cspec_report_time_taken_for_tests();        \
-    }                                              \
+#define _cspec_run_suite_block(display_filter, ...) \
+  do {                                              \
+    _cspec_setup_test_data(display_filter);         \
+    cspec->discovering = _cspec_true;               \
+    __VA_ARGS__;                                    \
+    cspec->discovering = _cspec_false;              \
+    if(cspec->list_tests) {                         \
+      _cspec_list_tests();                          \
+    } else {                                        \
+      _cspec_run_tree();                            \
+      _cspec_report_time_taken_for_tests();         \
+      if(_cspec_reached_max_failures()) {           \
+        exit(EXIT_FAILURE);                         \
+      }                                             \
+    }                                               \
+  } while(0)
+
+/**
+ * @brief A simple function definition for running test suites. The block
+ * is executed once to discover every module, describe and it. Only then
+ * are the selected tests run, module by module, by walking that tree. A
+ * run cut short by CSPEC_MAX_FAILURES exits with EXIT_FAILURE after the
+ * report
+ * @param type_of_tests -> passing|failing|skipped|all, or a comma separated
+ * combination of them like "failing,skipped"
+ * @param ... -> The block of modules to run
+ */
+#define cspec_run_suite(type_of_tests, ...)                                   \
+  do {                                                                        \
+    unsigned int display_filter = _cspec_parse_display_filter(type_of_tests); \
+    if(display_filter == 0) {                                                 \
+      printf(                                                                 \
+        "\n\033[1;31mInput a type of test to log "                            \
+        "passing|failing|skipped|all\033[0m\n\n"                              \
+      );                                                                      \
+    } else {                                                                  \
+      _cspec_run_suite_block(display_filter, __VA_ARGS__);                    \
+    }                                                                         \
+  } while(0)
+
+/**
+ * @brief Runs a suite with the runner options given on the command line,
+ * like `--jobs=4 --filter=vector --seed=42`, which take precedence over
+ * the CSPEC_* environment. The arguments are read once before the suite
+ * is discovered. The process then exits with EXIT_SUCCESS when no test
+ * failed, EXIT_FAILURE when any did, or CSPEC_EXIT_USAGE when the
+ * arguments could not be read
+ * @param argc -> The argc of main
+ * @param argv -> The argv of main
+ * @param ... -> The block of modules to run
+ */
+#define cspec_run_suite_argv(argc, argv, ...)                              \
+  do {                                                                     \
+    unsigned int display_filter = _cspec_parse_arguments((argc), (argv));  \
+    _cspec_run_suite_block(display_filter, __VA_ARGS__);                   \
+    exit(                                                                  \
+      cspec->number_of_failing_tests > 0 ? EXIT_FAILURE : EXIT_SUCCESS     \
+    );                                                                     \
   } while(0)
 
+#define _cspec_module_block(suite_name, skipped, background, ...) \
+  static void suite_name(void) {                                  \
+    if(_cspec_enter_module(                                       \
+         #suite_name, __FILE__, __LINE__, suite_name, (skipped)   \
+       ) != CSPEC_NO_NODE) {                                      \
+      cspec->in_skipped_module   = (skipped);                     \
+      cspec->in_skipped_describe = (skipped);                     \
+      cspec->before_func         = NULL;                          \
+      cspec->after_func          = NULL;                          \
+      cspec->timeout             = 0;                             \
+      if(!cspec->discovering &&                                   \
+         _cspec_first_walk_into(cspec->parent_node)) {            \
+        _cspec_printf(                                            \
+          "\n%s%sModule `%s`%s\n",                                \
+          (background),                                           \
+          (skipped) ? "" : cspec->YELLOW,                         \
+          #suite_name,                                            \
+          cspec->RESET                                            \
+        );                                                        \
+      }                                                           \
+      _cspec_set_depth(0);                                        \
+      __VA_ARGS__;                                                \
+      _cspec_wait_for_tests(0);                                   \
+      _cspec_leave_node();                                        \
+      cspec->in_skipped_module   = _cspec_false;                  \
+      cspec->in_skipped_describe = _cspec_false;                  \
+    }                                                             \
+  }
+
 /**
  * @brief Expands to a function definition of the test suite
  * @param suite_name -> The name for the new module of tests
  * @param ... -> The block to define
  */
-#define module(suite_name, ...)              \
-  static void suite_name(void) {             \
-    cspec->in_skipped_module = _cspec_false; \
-    printf(                                  \
-      "\n%s%sModule `%s`%s\n",               \
-      cspec->BACK_PURPLE,                    \
-      cspec->YELLOW,                         \
-      #suite_name,                           \
-      cspec->RESET                           \
-    );                                       \
-    _cspec_string_free(cspec->display_tab);  \
-    __VA_ARGS__;                             \
-  }
+#define module(suite_name, ...) \
+  _cspec_module_block(suite_name, _cspec_false, cspec->BACK_PURPLE, __VA_ARGS__)
 
 /**
  * @brief Temporarily disables a module and all its tests
  * @param suite_name -> The name of the module to run
  * @param ... -> The actual test code
  */
-#define xmodule(suite_name, ...)                                         \
-  static void suite_name(void) {                                         \
-    cspec->in_skipped_module   = _cspec_true;                            \
-    cspec->in_skipped_describe = _cspec_true;                            \
-    printf(                                                              \
-      "\n%sModule `%s`%s\n", cspec->BACK_GRAY, #suite_name, cspec->RESET \
-    );                                                                   \
-    _cspec_string_free(cspec->display_tab);                              \
-    __VA_ARGS__;                                                         \
-    cspec->in_skipped_module   = _cspec_false;                           \
-    cspec->in_skipped_describe = _cspec_false;                           \
-  }
+#define xmodule(suite_name, ...) \
+  _cspec_module_block(suite_name, _cspec_true, cspec->BACK_GRAY, __VA_ARGS__)
 
 /**
- * @brief Expands to a setup proc that gets executed before the tests
+ * @brief Expands to a setup proc that gets executed before the tests.
+ * Discovery skips it, it only runs when tests of the block are selected.
+ * When the tests are shuffled it runs on every walk into its block
  * @param ... -> The proc to run
  */
-#define before(...) __VA_ARGS__
+#define before(...)           \
+  do {                        \
+    if(!cspec->discovering) { \
+      _cspec_break_batch();   \
+      __VA_ARGS__;            \
+    }                         \
+  } while(0)
 
 /**
- * @brief Expands to a teardown proc that gets executed after the tests
+ * @brief Expands to a teardown proc that gets executed after the tests.
+ * When the tests are shuffled it runs on every walk into its block
  * @param ... -> The proc to run
  */
-#define after(...) __VA_ARGS__
+#define after(...)            \
+  do {                        \
+    if(!cspec->discovering) { \
+      _cspec_break_batch();   \
+      __VA_ARGS__;            \
+    }                         \
+  } while(0)
 
 /**
  * @brief Sets the argument to a function to run before each it block
@@ -330,14 +627,43 @@ static void __cspec_string_internal_addf(char **self, const char *f, ...) {
  */
 #define after_each(func) cspec->after_func = func
 
-#define _cspec_describe_context_block(object_name, color, ...)             \
-  do {                                                                     \
-    _cspec_string_add(cspec->display_tab, "    ");                         \
-    printf(                                                                \
-      "%s%s`%s`%s\n", cspec->display_tab, color, object_name, cspec->RESET \
-    );                                                                     \
-    __VA_ARGS__;                                                           \
-    _cspec_string_skip_first(cspec->display_tab, 4);                       \
+/**
+ * @brief Fails every following it block of the module that runs longer
+ * than the limit, instead of waiting for it forever. 0 falls back to the
+ * default of CSPEC_TIMEOUT
+ * @param milliseconds -> The time each test is allowed to take
+ */
+#define timeout_each(milliseconds)        \
+  do {                                    \
+    cspec->timeout = (milliseconds);      \
+    if(cspec->timeout > 0) {              \
+      cspec->uses_timeouts = _cspec_true; \
+    }                                     \
+    if(!cspec->discovering) {             \
+      _cspec_break_batch();               \
+    }                                     \
+  } while(0)
+
+#define _cspec_describe_context_block(object_name, color, ...) \
+  do {                                                         \
+    if(_cspec_enter_node(                                      \
+         CSPEC_NODE_DESCRIBE, object_name, __FILE__, __LINE__  \
+       ) != CSPEC_NO_NODE) {                                   \
+      if(!cspec->discovering) {                                \
+        _cspec_set_depth(cspec->depth + 1);                    \
+        if(_cspec_first_walk_into(cspec->parent_node)) {       \
+          _cspec_printf(                                       \
+            "%s%s`%s`%s\n",                                    \
+            cspec->display_tab,                                \
+            color,                                             \
+            object_name,                                       \
+            cspec->RESET                                       \
+          );                                                   \
+        }                                                      \
+      }                                                        \
+      __VA_ARGS__;                                             \
+      _cspec_leave_node();                                     \
+    }                                                          \
   } while(0)
 
 /**
@@ -384,33 +710,9 @@ static void __cspec_string_internal_addf(char **self, const char *f, ...) {
  * @param proc_name -> The name of test to run
  * @param ... -> The actual test code
  */
-#define xit(proc_name, ...)                          \
-  do {                                               \
-    if(cspec->before_func) {                         \
-      (*cspec->before_func)();                       \
-    }                                                \
-    _cspec_string_add(cspec->display_tab, "    ");   \
-                                                     \
-    cspec->number_of_tests++;                        \
-    cspec->number_of_skipped_tests++;                \
-    _cspec_string_free(cspec->test_result_message);  \
-    if(                                              \
-      !strncmp(cspec->type_of_tests, "all", 3) ||    \
-      !strncmp(cspec->type_of_tests, "skipped", 7)   \
-    ) {                                              \
-      printf(                                        \
-        "%s%s- %s%s\n",                              \
-        cspec->display_tab,                          \
-        cspec->GRAY,                                 \
-        proc_name,                                   \
-        cspec->RESET                                 \
-      );                                             \
-    }                                                \
-                                                     \
-    _cspec_string_skip_first(cspec->display_tab, 4); \
-    if(cspec->after_func) {                          \
-      (*cspec->after_func)();                        \
-    }                                                \
+#define xit(proc_name, ...)                                              \
+  do {                                                                   \
+    (void)_cspec_enter_test(proc_name, __FILE__, __LINE__, _cspec_true); \
   } while(0)
 
 /**
@@ -418,73 +720,204 @@ static void __cspec_string_internal_addf(char **self, const char *f, ...) {
  * @param proc_name -> The name of test to run
  * @param proc -> The actual test code
  */
-#define it(proc_name, ...)                                                    \
-  do {                                                                        \
-    size_t start_test_timer;                                                  \
-    size_t end_test_timer;                                                    \
-    if(cspec->in_skipped_describe) {                                          \
-      xit(proc_name, __VA_ARGS__);                                            \
-    } else {                                                                  \
-      if(cspec->before_func) {                                                \
-        (*cspec->before_func)();                                              \
-      }                                                                       \
-                                                                              \
-      _cspec_string_add(cspec->display_tab, "    ");                          \
-      cspec->number_of_tests++;                                               \
-      _cspec_string_free(cspec->test_result_message);                         \
-                                                                              \
-      /* Assume its a passing test */                                         \
-      cspec->status_of_test = CSPEC_PASSING;                                  \
-      cspec->current_line   = __LINE__;                                       \
-      cspec->current_file   = __FILE__;                                       \
-                                                                              \
-      start_test_timer = cspec_timer();                                       \
-      __VA_ARGS__;                                                            \
-      end_test_timer = cspec_timer();                                         \
-                                                                              \
-      if(cspec->status_of_test == CSPEC_PASSING) {                            \
-        cspec->number_of_passing_tests++;                                     \
-        if(                                                                   \
-          !strncmp(cspec->type_of_tests, "all", 3) ||                         \
-          !strncmp(cspec->type_of_tests, "passing", 7)                        \
-        ) {                                                                   \
-          printf(                                                             \
-            "%s%s✓%s it %s%s\n",                                              \
-            cspec->display_tab,                                               \
-            cspec->GREEN,                                                     \
-            cspec->RESET,                                                     \
-            proc_name,                                                        \
-            cspec->RESET                                                      \
-          );                                                                  \
-        }                                                                     \
-      } else {                                                                \
-        /* Even if 1 of the asserts in the current it block fails, assume we  \
-         * have a failing test */                                             \
-        cspec->number_of_failing_tests++;                                     \
-        if(                                                                   \
-          !strncmp(cspec->type_of_tests, "all", 3) ||                         \
-          !strncmp(cspec->type_of_tests, "failing", 7)                        \
-        ) {                                                                   \
-          printf(                                                             \
-            "%s%s✗%s it %s:\n%s%s\n",                                         \
-            cspec->display_tab,                                               \
-            cspec->RED,                                                       \
-            cspec->RESET,                                                     \
-            proc_name,                                                        \
-            cspec->test_result_message,                                       \
-            cspec->RESET                                                      \
-          );                                                                  \
-        }                                                                     \
-      }                                                                       \
-                                                                              \
-      cspec->total_time_taken_for_tests += end_test_timer - start_test_timer; \
-      _cspec_string_skip_first(cspec->display_tab, 4);                        \
-      if(cspec->after_func) {                                                 \
-        (*cspec->after_func)();                                               \
-      }                                                                       \
-    }                                                                         \
+#define it(proc_name, ...)                                                  \
+  do {                                                                      \
+    size_t start_test_timer;                                                \
+    if(_cspec_enter_test(proc_name, __FILE__, __LINE__, _cspec_false)) {    \
+      _cspec_set_depth(cspec->depth + 1);                                   \
+      cspec->number_of_tests++;                                             \
+                                                                            \
+      /* Fixtures run next to the body, in the child when it is isolated */ \
+      if(_cspec_isolate_test()) {                                           \
+        if(cspec->before_func) {                                            \
+          (*cspec->before_func)();                                          \
+        }                                                                   \
+                                                                            \
+        _cspec_string_free(cspec->test_result_message);                     \
+                                                                            \
+        /* Assume its a passing test */                                     \
+        cspec->status_of_test = CSPEC_PASSING;                              \
+        cspec->current_line   = __LINE__;                                   \
+        cspec->current_file   = __FILE__;                                   \
+                                                                            \
+        start_test_timer = cspec_timer();                                   \
+        __VA_ARGS__;                                                        \
+        _cspec_finish_test(proc_name, cspec_timer() - start_test_timer);    \
+                                                                            \
+        _cspec_reset_arena();                                               \
+        if(cspec->after_func) {                                             \
+          (*cspec->after_func)();                                           \
+        }                                                                   \
+      }                                                                     \
+                                                                            \
+      _cspec_set_depth(cspec->depth - 1);                                   \
+    }                                                                       \
+  } while(0)
+
+/**
+ * @brief A describe whose tests carry tags like ":slow :io", on top of
+ * the tags of its parents, to be picked by CSPEC_TAGS
+ * @param object_name -> The name of the unit to describe
+ * @param tag_names -> The tags separated by spaces or commas
+ * @param ... -> The proc to extend to
+ */
+#define describe_tagged(object_name, tag_names, ...)   \
+  do {                                                 \
+    if(cspec->discovering) {                           \
+      cspec->next_tags = _cspec_parse_tags(tag_names); \
+    }                                                  \
+    describe(object_name, __VA_ARGS__);                \
+  } while(0)
+
+/**
+ * @brief A context with tags, like describe_tagged
+ * @param object_name -> The name of the unit to describe
+ * @param tag_names -> The tags separated by spaces or commas
+ * @param ... -> The proc to extend to
+ */
+#define context_tagged(object_name, tag_names, ...)    \
+  do {                                                 \
+    if(cspec->discovering) {                           \
+      cspec->next_tags = _cspec_parse_tags(tag_names); \
+    }                                                  \
+    context(object_name, __VA_ARGS__);                 \
+  } while(0)
+
+/**
+ * @brief A test with tags like ":slow :io", to be picked by CSPEC_TAGS.
+ * The tags are only read while discovering
+ * @param proc_name -> The name of test to run
+ * @param tag_names -> The tags separated by spaces or commas
+ * @param ... -> The actual test code
+ */
+#define it_tagged(proc_name, tag_names, ...)           \
+  do {                                                 \
+    if(cspec->discovering) {                           \
+      cspec->next_tags = _cspec_parse_tags(tag_names); \
+    }                                                  \
+    it(proc_name, __VA_ARGS__);                        \
   } while(0)
 
+/**
+ * @brief Nesting deeper than this keeps the indentation of the last level
+ */
+#ifndef CSPEC_MAX_DEPTH
+  #define CSPEC_MAX_DEPTH 16
+#endif
+
+/** @brief -> The id of a node that does not exist */
+#define CSPEC_NO_NODE ((size_t)-1)
+
+/** @brief -> The duration of a test that was never timed */
+#define CSPEC_NO_DURATION ((size_t)-1)
+
+/** @brief -> The exit status of a suite started with options it cannot use */
+#define CSPEC_EXIT_USAGE 2
+
+/** @brief -> The number of distinct tags a suite can use */
+#define CSPEC_MAX_TAGS 64
+
+/**
+ * @brief The number of alternatives a CSPEC_TAGS expression can expand to
+ */
+#ifndef CSPEC_MAX_TAG_CLAUSES
+  #define CSPEC_MAX_TAG_CLAUSES 64
+#endif
+
+typedef enum {
+  CSPEC_NODE_MODULE,
+  CSPEC_NODE_DESCRIBE,
+  CSPEC_NODE_IT
+} _cspec_node_kind;
+
+/**
+ * @brief A module, describe/context or it found while discovering tests.
+ * Nodes are stored in source order, so their index is a stable id and the
+ * descendants of a node are exactly the ids in [id + 1, end)
+ * @param kind -> What kind of block this node is
+ * @param skipped -> Set for xmodule, xdescribe, xcontext, xit and their
+ * children
+ * @param depth -> How deeply the node is nested, modules are at 0
+ * @param name -> The name of the block
+ * @param file -> The __FILE__ the block is written in
+ * @param line -> The __LINE__ the block is written in
+ * @param parent -> The id of the enclosing node, or CSPEC_NO_NODE
+ * @param end -> One past the id of the last descendant
+ * @param selected -> The number of tests under this node that will run
+ * @param tags -> A bit for every tag of the node and of its parents
+ * @param function -> For modules, the function that executes them
+ * @param hash -> FNV-1a of the names on the path from the module down
+ * @param expected -> The duration of the test in the history file
+ * @param duration -> The duration of the test measured by this run
+ * @param failed -> Set when the test failed in this run
+ * @param journaled -> Set when the test failed in the run before
+ */
+typedef struct {
+  _cspec_node_kind kind;
+  cspec_bool skipped;
+  size_t depth;
+  const char *name;
+  const char *file;
+  size_t line;
+  size_t parent;
+  size_t end;
+  size_t selected;
+  unsigned long long tags;
+  void (*function)(void);
+  unsigned long long hash;
+  size_t expected;
+  size_t duration;
+  cspec_bool failed;
+  cspec_bool journaled;
+} _cspec_node;
+
+/**
+ * @brief One run of a test while the suite repeats
+ * @param duration -> The time it took, or CSPEC_NO_DURATION if its module
+ * was lost
+ */
+typedef struct {
+  size_t id;
+  size_t duration;
+  cspec_bool failed;
+} _cspec_sample;
+
+#if defined(CSPEC_HAS_FORK)
+/**
+ * @brief Consecutive tests of a block that run in one forked child while
+ * the suite moves on
+ * @param pid -> The child running the tests
+ * @param fd -> The read end of the pipe the child reports through
+ * @param ids -> The nodes of the tests, in the order they run
+ * @param breaks -> The value of `batch_breaks` the batch belongs to
+ * @param display_tab -> The indentation the tests are printed with
+ * @param offset -> Where their results go in the buffered output
+ * @param done -> Set once the child exited
+ * @param status -> The wait status of the child
+ * @param buffer -> The reports the child sent
+ * @param limit -> The time each test of the batch may take in ms, or 0
+ * @param deadline -> When the child gets killed unless it reports, or 0
+ * @param timed_out -> Set once the child got killed for running too long
+ */
+typedef struct {
+  pid_t pid;
+  int fd;
+  size_t *ids;
+  size_t number_of_tests;
+  size_t breaks;
+  const char *display_tab;
+  size_t offset;
+  cspec_bool done;
+  int status;
+  char *buffer;
+  size_t size;
+  size_t capacity;
+  size_t limit;
+  size_t deadline;
+  cspec_bool timed_out;
+} _cspec_isolated_batch;
+#endif
+
 /**
  * @brief Global variables grouped in container
  * @param number_of_tests -> The total number of tests performed
@@ -497,18 +930,72 @@ static void __cspec_string_internal_addf(char **self, const char *f, ...) {
  * @param in_skipped_describe -> Flag that skips xdescribe and xcontext
  *
  * @param test_result_message -> The string builder we construct for assertions
- * @param display_tab -> 4 space overhead for a nicer display of test results
+ * @param depth -> How deeply the current block is nested
+ * @param display_tab -> The indentation for `depth`, 4 spaces per level
+ * @param indentation -> Every indentation up to CSPEC_MAX_DEPTH, precomputed
+ * @param indentation_spaces -> The backing spaces of `indentation`
  *
- * @param type_of_tests -> The type of tests we want to display
+ * @param display_filter -> CSPEC_DISPLAY_* bits of the results to print
  * @param current_file -> Current __FILE__ used for tracking assert positions
  * @param current_line -> Current value of the __LINE__ macro
  * @param current_actual -> Current actual value token
  * @param current_expected -> Current expected value token
  * @param position_in_file -> A string containing __FILE__ and __LINE__ results
  *
+ * @param arena -> Backing memory for all of the strings above
+ *
  * @param before_func -> A function pointer to be executed before it blocks
  * @param after_func -> A function pointer to be executed after it blocks
  *
+ * @param discovering -> Set while the suite is walked to build the tree
+ * @param list_tests -> Print the tree instead of running it (CSPEC_LIST)
+ * @param selected_id -> Only run the tests under this id (CSPEC_ID)
+ * @param filter -> Only run the tests whose path matches (CSPEC_FILTER)
+ * @param tag_expression -> Only run the tests whose tags match (CSPEC_TAGS)
+ * @param tag_names -> The name of every tag, by its bit
+ * @param tag_lengths -> The length of every name in `tag_names`
+ * @param number_of_tags -> The number of distinct tags seen so far
+ * @param next_tags -> The tags of the block that is about to be discovered
+ * @param nodes -> Every block of the suite in source order
+ * @param number_of_nodes -> The number of discovered nodes
+ * @param capacity_of_nodes -> The number of nodes that fit in `nodes`
+ * @param parent_node -> The innermost open module or describe block
+ * @param next_node -> The id the next block will match while running
+ * @param current_test -> The id of the `it` block that is running
+ * @param history -> The file test durations are kept in (CSPEC_HISTORY)
+ * @param journal -> The file failing tests are kept in (CSPEC_JOURNAL)
+ * @param rerun_failed -> Only run the tests in the journal
+ * @param shard_index -> The shard of the suite to run (CSPEC_SHARD_INDEX)
+ * @param shard_count -> The number of shards (CSPEC_SHARD_COUNT)
+ * @param balance_shards -> Split shards by duration (CSPEC_SHARD_BALANCE)
+ * @param random_order -> Shuffle the modules and tests (CSPEC_ORDER)
+ * @param seed -> What the shuffles start from (CSPEC_SEED)
+ * @param walk_target -> The only test a shuffled walk of a module enters
+ * @param previous_target -> The test the walk before went to
+ * @param repeat -> The number of times the tests run (CSPEC_REPEAT)
+ * @param until_failure -> Repeat until a test fails (CSPEC_UNTIL_FAILURE)
+ * @param samples -> Every run of every test while repeating
+ * @param number_of_samples -> The number of runs in `samples`
+ * @param capacity_of_samples -> The number of runs that fit in `samples`
+ * @param max_failures -> Stop after this many failing tests, 0 never stops
+ * @param jobs -> The number of worker processes modules are spread over
+ * @param threads -> The number of pool threads modules are spread over
+ * @param isolate -> The number of forked children that run tests at once
+ * @param isolate_batch -> The number of tests each of them runs
+ * @param isolated -> The forked batches whose results are not printed yet
+ * @param running_isolated -> The number of them still running
+ * @param batch_breaks -> Counts the blocks that end the batch being filled
+ * @param report_fd -> Where a forked child sends its results, or -1
+ * @param batch_size -> The number of tests a forked child took so far
+ * @param buffering -> Set while results are collected into `output`
+ * @param output -> The results printed by this context on a pool thread
+ * @param output_size -> The number of bytes written to `output`
+ * @param output_capacity -> The number of bytes that fit in `output`
+ * @param timeout -> The limit set by timeout_each in milliseconds
+ * @param default_timeout -> The limit of every other test (CSPEC_TIMEOUT)
+ * @param uses_timeouts -> Set once any test of the suite has a limit
+ * @param catch_crashes -> Fails tests that crash instead of the runner
+ *
  * @param COLORS -> Terminal string color codes
  */
 typedef struct _cspec_data_struct {
@@ -522,18 +1009,76 @@ typedef struct _cspec_data_struct {
   cspec_bool in_skipped_describe;
 
   char *test_result_message;
-  char *display_tab;
+  size_t depth;
+  const char *display_tab;
+  const char *indentation[CSPEC_MAX_DEPTH + 1];
+  char indentation_spaces[4 * CSPEC_MAX_DEPTH + 1];
 
-  const char *type_of_tests;
+  unsigned int display_filter;
   const char *current_file;
   size_t current_line;
   char *current_actual;
   char *current_expected;
   char *position_in_file;
 
+  _cspec_arena arena;
+
   void (*before_func)(void);
   void (*after_func)(void);
 
+  cspec_bool discovering;
+  cspec_bool list_tests;
+  size_t selected_id;
+  const char *filter;
+  const char *tag_expression;
+  const char *tag_names[CSPEC_MAX_TAGS];
+  size_t tag_lengths[CSPEC_MAX_TAGS];
+  size_t number_of_tags;
+  unsigned long long next_tags;
+  _cspec_node *nodes;
+  size_t number_of_nodes;
+  size_t capacity_of_nodes;
+  size_t parent_node;
+  size_t next_node;
+  size_t current_test;
+  const char *history;
+  const char *journal;
+  cspec_bool rerun_failed;
+  size_t shard_index;
+  size_t shard_count;
+  cspec_bool balance_shards;
+  cspec_bool random_order;
+  unsigned long long seed;
+  size_t walk_target;
+  size_t previous_target;
+  size_t repeat;
+  cspec_bool until_failure;
+  _cspec_sample *samples;
+  size_t number_of_samples;
+  size_t capacity_of_samples;
+  size_t max_failures;
+  size_t jobs;
+  size_t threads;
+  size_t isolate;
+  size_t isolate_batch;
+#if defined(CSPEC_HAS_FORK)
+  _cspec_isolated_batch *isolated;
+  size_t number_of_isolated;
+  size_t capacity_of_isolated;
+  size_t running_isolated;
+  size_t batch_breaks;
+  int report_fd;
+  size_t batch_size;
+#endif
+  cspec_bool buffering;
+  char *output;
+  size_t output_size;
+  size_t output_capacity;
+  size_t timeout;
+  size_t default_timeout;
+  cspec_bool uses_timeouts;
+  cspec_bool catch_crashes;
+
   const char *GREEN;
   const char *RED;
   const char *YELLOW;
@@ -546,66 +1091,3315 @@ typedef struct _cspec_data_struct {
   const char *BACK_GRAY;
 } _cspec_data_struct;
 
-static _cspec_data_struct *cspec;
+/**
+ * @brief Every thread of the pool runs tests against its own context
+ */
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  #define CSPEC_THREAD_LOCAL thread_local
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+  #define CSPEC_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+  #define CSPEC_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+  #define CSPEC_THREAD_LOCAL __declspec(thread)
+#else
+  #define CSPEC_THREAD_LOCAL
+#endif
+
+static CSPEC_THREAD_LOCAL _cspec_data_struct *cspec;
 
 /**
- * @param CSPEC_PASSING -> Set for passing tests
- * @param CSPEC_FAILING -> Set for failing tests
+ * @brief Formats straight into the spare capacity of the string. Only when
+ * the result does not fit is the vector grown once to the measured length
+ * and the format repeated, so nothing is ever truncated or copied twice
  */
-#define CSPEC_PASSING _cspec_true
-#define CSPEC_FAILING _cspec_false
+static void __cspec_string_internal_addf(char **self, const char *f, ...) {
+  signed int result = 0;
+  size_t size       = _cspec_string_size(*self);
+  size_t spare      = *self ? _cspec_vector_capacity(*self) - size : 0;
+  va_list args;
 
-#define is    ==
-#define isnot !=
+  va_start(args, f)
+    ;
+    result = vsnprintf(*self ? *self + size : NULL, spare, f, args);
+  va_end(args);
 
-#define equals ,
-#define to
-#define with
-#define array_size ,
+  if(result < 0) {
+    return;
+  }
+
+  if((size_t)result >= spare) {
+    __cspec_vector_maybegrow(*self, (size_t)result + 1);
+    va_start(args, f)
+      ;
+      vsnprintf(*self + size, (size_t)result + 1, f, args);
+    va_end(args);
+  }
+
+  __cspec_vector_get_header(*self)->size += (size_t)result;
+}
 
 /**
- * @brief Report the number of tests and time taken while testing
+ * @brief Prints a result, or appends it to the output of the context when
+ * it runs on a thread of the pool
  */
-#define _cspec_report_time_taken_for_tests()                        \
-  do {                                                              \
-    printf(                                                         \
-      "\n%s● %zu tests\n%s✓ %zu passing\n%s✗ %zu failing\n%s- %zu " \
-      "skipped%s\n",                                                \
-      cspec->YELLOW,                                                \
-      cspec->number_of_tests,                                       \
-      cspec->GREEN,                                                 \
-      cspec->number_of_passing_tests,                               \
-      cspec->RED,                                                   \
-      cspec->number_of_failing_tests,                               \
-      cspec->GRAY,                                                  \
-      cspec->number_of_skipped_tests,                               \
-      cspec->RESET                                                  \
-    );                                                              \
-                                                                    \
-    /* Print in seconds if the time is more than 100ms */           \
-    if(cspec->total_time_taken_for_tests > 100000000) {             \
-      printf(                                                       \
-        "%s★ Finished in %.5f seconds%s\n",                         \
-        cspec->CYAN,                                                \
-        cspec->total_time_taken_for_tests / 1000000000.0,           \
-        cspec->RESET                                                \
-      );                                                            \
-    } /* Else print in miliseconds */                               \
-    else {                                                          \
-      printf(                                                       \
-        "%s★ Finished in %.5f ms%s\n",                              \
-        cspec->CYAN,                                                \
-        cspec->total_time_taken_for_tests / 1000000.0,              \
-        cspec->RESET                                                \
-      );                                                            \
-    }                                                               \
-  } while(0)
+static void _cspec_printf(const char *format, ...) {
+  signed int result;
+  size_t spare = cspec->output_capacity - cspec->output_size;
+  va_list args;
+
+  va_start(args, format);
+  if(!cspec->buffering) {
+    vprintf(format, args);
+    va_end(args);
+    return;
+  }
+  result = vsnprintf(
+    cspec->output ? cspec->output + cspec->output_size : NULL,
+    spare,
+    format,
+    args
+  );
+  va_end(args);
+
+  if(result < 0) {
+    return;
+  }
+
+  if((size_t)result >= spare) {
+    cspec->output_capacity = 2 * cspec->output_capacity + (size_t)result + 1;
+    cspec->output = (char *)realloc(cspec->output, cspec->output_capacity);
+    va_start(args, format);
+    vsnprintf(
+      cspec->output + cspec->output_size, (size_t)result + 1, format, args
+    );
+    va_end(args);
+  }
+
+  cspec->output_size += (size_t)result;
+}
 
 /**
- * @brief Allocates memory for vectors to save test results in
+ * @brief Rewinds the string arena once an `it` block has been reported
  */
-#define _cspec_setup_test_data(type)                                       \
-  do {                                                                     \
+#define _cspec_reset_arena()           \
+  do {                                 \
+    cspec->test_result_message = NULL; \
+    cspec->current_actual      = NULL; \
+    cspec->current_expected    = NULL; \
+    cspec->position_in_file    = NULL; \
+    _cspec_arena_reset(&cspec->arena); \
+  } while(0)
+
+/**
+ * @brief Moves to another nesting level, picking its indentation out of
+ * the precomputed table instead of building a string
+ */
+#define _cspec_set_depth(new_depth)                                      \
+  do {                                                                   \
+    cspec->depth       = (new_depth);                                    \
+    cspec->display_tab = cspec->indentation                              \
+      [cspec->depth < CSPEC_MAX_DEPTH ? cspec->depth : CSPEC_MAX_DEPTH]; \
+  } while(0)
+
+/** @brief -> The characters a tag name is made of */
+#define _cspec_is_tag_character(c)                             \
+  (((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z') || \
+   ((c) >= '0' && (c) <= '9') || (c) == '_' || (c) == '-' || (c) == '.')
+
+/**
+ * @brief Looks up the bit of a tag that a block declared
+ * @return The bit of the tag, or 0 when no block declared it
+ */
+static unsigned long long _cspec_find_tag(const char *name, size_t length) {
+  size_t tag;
+
+  for(tag = 0; tag < cspec->number_of_tags; tag++) {
+    if(cspec->tag_lengths[tag] == length &&
+       !strncmp(cspec->tag_names[tag], name, length)) {
+      return 1ULL << tag;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Looks up the bit of a tag, handing out the next free one to a
+ * name that was not seen before
+ * @return The bit of the tag, or 0 when CSPEC_MAX_TAGS are in use
+ */
+static unsigned long long _cspec_tag_bit(const char *name, size_t length) {
+  unsigned long long bit = _cspec_find_tag(name, length);
+
+  if(bit != 0) {
+    return bit;
+  }
+  if(cspec->number_of_tags == CSPEC_MAX_TAGS) {
+    printf(
+      "\n\033[1;31mA suite can only use %d tags, ignoring `%.*s`\033[0m\n",
+      CSPEC_MAX_TAGS,
+      (int)length,
+      name
+    );
+    return 0;
+  }
+
+  cspec->tag_names[cspec->number_of_tags]   = name;
+  cspec->tag_lengths[cspec->number_of_tags] = length;
+  return 1ULL << cspec->number_of_tags++;
+}
+
+/**
+ * @brief Turns a list of tags like ":slow :io" or "slow, io" into their bits
+ * @param tag_names -> The tags, which have to outlive the suite
+ */
+static inline unsigned long long _cspec_parse_tags(const char *tag_names) {
+  unsigned long long tags = 0;
+
+  while(*tag_names != '\0') {
+    const char *name = tag_names;
+
+    while(_cspec_is_tag_character(*tag_names)) {
+      tag_names++;
+    }
+    if(tag_names > name) {
+      tags |= _cspec_tag_bit(name, (size_t)(tag_names - name));
+    } else {
+      tag_names++;
+    }
+  }
+
+  return tags;
+}
+
+/**
+ * @brief Appends a node under the innermost open one while discovering.
+ * The node takes the tags of its parent along with the ones given to it
+ * @return The id of the new node
+ */
+static size_t _cspec_push_node(
+  _cspec_node_kind kind,
+  const char *name,
+  const char *file,
+  size_t line,
+  cspec_bool skipped
+) {
+  _cspec_node *node;
+  const char *c;
+
+  if(cspec->number_of_nodes == cspec->capacity_of_nodes) {
+    cspec->capacity_of_nodes =
+      cspec->capacity_of_nodes ? 2 * cspec->capacity_of_nodes : 64;
+    cspec->nodes = (_cspec_node *)realloc(
+      cspec->nodes, cspec->capacity_of_nodes * sizeof(_cspec_node)
+    );
+  }
+
+  node           = &cspec->nodes[cspec->number_of_nodes];
+  node->kind     = kind;
+  node->skipped  = skipped;
+  node->depth    = 0;
+  node->name     = name;
+  node->file     = file;
+  node->line     = line;
+  node->parent   = cspec->parent_node;
+  node->end      = cspec->number_of_nodes + 1;
+  node->selected = 0;
+  node->tags     = cspec->next_tags;
+  node->function = NULL;
+  node->hash     = 14695981039346656037ULL;
+  node->expected  = CSPEC_NO_DURATION;
+  node->duration  = CSPEC_NO_DURATION;
+  node->failed    = _cspec_false;
+  node->journaled = _cspec_false;
+  if(node->parent != CSPEC_NO_NODE) {
+    node->depth = cspec->nodes[node->parent].depth + 1;
+    node->tags |= cspec->nodes[node->parent].tags;
+    node->hash  = cspec->nodes[node->parent].hash;
+    node->hash  = (node->hash ^ '/') * 1099511628211ULL;
+  }
+  for(c = name; *c != '\0'; c++) {
+    node->hash = (node->hash ^ (unsigned char)*c) * 1099511628211ULL;
+  }
+  cspec->next_tags = 0;
+
+  return cspec->number_of_nodes++;
+}
+
+/**
+ * @brief Set once the failing tests reached CSPEC_MAX_FAILURES, after which
+ * no other block is entered
+ */
+#define _cspec_reached_max_failures() \
+  (cspec->max_failures > 0 &&         \
+   cspec->number_of_failing_tests >= cspec->max_failures)
+
+/**
+ * @brief Tells whether the walk to a test passes through a node
+ * @param target -> The test of the walk, or CSPEC_NO_NODE
+ * @param id -> The node
+ */
+#define _cspec_walks_into(target, id) \
+  ((target) >= (id) && (target) < cspec->nodes[id].end)
+
+/**
+ * @brief Set unless the tests are shuffled and the walk before this one
+ * already went through the node, so that its header only prints once
+ */
+#define _cspec_first_walk_into(id) \
+  (!_cspec_walks_into(cspec->previous_target, id))
+
+/**
+ * @brief Ends the batch of forked tests being filled at a block that the
+ * parent prints or runs itself, a forked child stops right there
+ */
+static void _cspec_break_batch(void) {
+#if defined(CSPEC_HAS_FORK)
+  if(cspec->report_fd >= 0) {
+    fflush(stdout);
+    _exit(0);
+  }
+  cspec->batch_breaks++;
+#endif
+}
+
+/**
+ * @brief Opens a module or describe block. While discovering the node gets
+ * registered, otherwise the next node of the tree is matched and skipped
+ * along with all of its children when none of its tests are selected or
+ * too many tests failed already. The suite has to expand to the same
+ * blocks on both walks
+ * @return The id of the node, or CSPEC_NO_NODE if the block should not run
+ */
+static size_t _cspec_enter_node(
+  _cspec_node_kind kind, const char *name, const char *file, size_t line
+) {
+  size_t id = cspec->next_node;
+
+  if(cspec->discovering) {
+    id = _cspec_push_node(kind, name, file, line, cspec->in_skipped_describe);
+    cspec->parent_node = id;
+    return id;
+  }
+
+  if(id >= cspec->number_of_nodes || cspec->nodes[id].kind != kind) {
+    return CSPEC_NO_NODE;
+  }
+  if(cspec->nodes[id].selected == 0 || _cspec_reached_max_failures() ||
+     (cspec->walk_target != CSPEC_NO_NODE &&
+      !_cspec_walks_into(cspec->walk_target, id))) {
+    cspec->next_node = cspec->nodes[id].end;
+    return CSPEC_NO_NODE;
+  }
+
+  if(kind != CSPEC_NODE_IT) {
+    _cspec_break_batch();
+    cspec->parent_node = id;
+  }
+  cspec->next_node = id + 1;
+  return id;
+}
+
+static size_t _cspec_enter_module(
+  const char *name,
+  const char *file,
+  size_t line,
+  void (*function)(void),
+  cspec_bool skipped
+) {
+  size_t id;
+
+  if(!cspec->discovering) {
+    return _cspec_enter_node(CSPEC_NODE_MODULE, name, file, line);
+  }
+
+  id = _cspec_push_node(CSPEC_NODE_MODULE, name, file, line, skipped);
+  cspec->nodes[id].function = function;
+  cspec->parent_node        = id;
+  return id;
+}
+
+/**
+ * @brief Closes the innermost open block. The id is kept in the context
+ * rather than in the expansion, so nested blocks declare no locals
+ */
+static void _cspec_leave_node(void) {
+  size_t id          = cspec->parent_node;
+  cspec->parent_node = cspec->nodes[id].parent;
+
+  if(cspec->discovering) {
+    cspec->nodes[id].end = cspec->number_of_nodes;
+    return;
+  }
+
+  _cspec_break_batch();
+  if(cspec->nodes[id].kind == CSPEC_NODE_DESCRIBE) {
+    _cspec_set_depth(cspec->depth - 1);
+  }
+}
+
+/**
+ * @brief Reports a test that was disabled with xit or by its parents
+ * @param name -> The name of the test
+ */
+static void _cspec_skip_test(const char *name) {
+  _cspec_break_batch();
+  if(cspec->before_func) {
+    (*cspec->before_func)();
+  }
+  _cspec_set_depth(cspec->depth + 1);
+
+  cspec->number_of_tests++;
+  cspec->number_of_skipped_tests++;
+  _cspec_string_free(cspec->test_result_message);
+  if(cspec->display_filter & CSPEC_DISPLAY_SKIPPED) {
+    _cspec_printf(
+      "%s%s- %s%s\n", cspec->display_tab, cspec->GRAY, name, cspec->RESET
+    );
+  }
+
+  _cspec_set_depth(cspec->depth - 1);
+  _cspec_reset_arena();
+  if(cspec->after_func) {
+    (*cspec->after_func)();
+  }
+}
+
+/**
+ * @brief Registers or matches an it block
+ * @return True when the body of the test should be executed
+ */
+static cspec_bool _cspec_enter_test(
+  const char *name, const char *file, size_t line, cspec_bool skipped
+) {
+  skipped = skipped || cspec->in_skipped_describe;
+
+  if(cspec->discovering) {
+    _cspec_push_node(CSPEC_NODE_IT, name, file, line, skipped);
+    return _cspec_false;
+  }
+
+  cspec->current_test = _cspec_enter_node(CSPEC_NODE_IT, name, file, line);
+  if(cspec->current_test == CSPEC_NO_NODE) {
+    return _cspec_false;
+  }
+  if(skipped) {
+    _cspec_skip_test(name);
+    return _cspec_false;
+  }
+  return _cspec_true;
+}
+
+/**
+ * @brief Names a test across runs. Twin tests with the same path only
+ * differ by where they are written, so the history and the journal key
+ * them by the hash of their path together with a hash of `<file>:<line>`
+ */
+typedef struct {
+  unsigned long long hash;
+  unsigned long long location;
+} _cspec_test_key;
+
+/**
+ * @brief A test duration read from the history file
+ */
+typedef struct {
+  _cspec_test_key key;
+  size_t duration;
+} _cspec_history_entry;
+
+/**
+ * @brief Orders keys, and history entries through their first member
+ */
+static int _cspec_compare_keys(const void *a, const void *b) {
+  const _cspec_test_key *left  = (const _cspec_test_key *)a;
+  const _cspec_test_key *right = (const _cspec_test_key *)b;
+
+  if(left->hash != right->hash) {
+    return left->hash < right->hash ? -1 : 1;
+  }
+  return left->location < right->location ? -1
+                                          : left->location > right->location;
+}
+
+/**
+ * @brief Carries an FNV-1a hash on over the characters of `text`
+ */
+static unsigned long long _cspec_hash_text(
+  unsigned long long hash, const char *text
+) {
+  for(; *text != '\0'; text++) {
+    hash = (hash ^ (unsigned char)*text) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+/**
+ * @brief The key of a test of the tree, hashing its place the way it is
+ * written to the files
+ */
+static _cspec_test_key _cspec_node_key(size_t id) {
+  _cspec_test_key key;
+  char line[32];
+
+  snprintf(line, sizeof(line), ":%zu", cspec->nodes[id].line);
+  key.hash     = cspec->nodes[id].hash;
+  key.location = _cspec_hash_text(
+    _cspec_hash_text(14695981039346656037ULL, cspec->nodes[id].file), line
+  );
+  return key;
+}
+
+/**
+ * @brief Reads the key at the start of a line of the history or journal
+ * and skips the rest of that line
+ * @return False once there are no more lines to read
+ */
+static cspec_bool _cspec_read_key(
+  FILE *file, _cspec_test_key *key, size_t *duration
+) {
+  char location[4096];
+
+  if(duration != NULL
+       ? fscanf(
+           file, "%llx %zu %4095s%*[^\n]", &key->hash, duration, location
+         ) != 3
+       : fscanf(file, "%llx %4095s%*[^\n]", &key->hash, location) != 2) {
+    return _cspec_false;
+  }
+  key->location = _cspec_hash_text(14695981039346656037ULL, location);
+  return _cspec_true;
+}
+
+/**
+ * @brief Reads the durations recorded by earlier runs into the expected
+ * duration of every test that still exists. Each line of the history is
+ * `<hash of the path> <nanoseconds> <file>:<line> <module>/.../<it>`
+ */
+static void _cspec_read_history(void) {
+  _cspec_history_entry *entries = NULL;
+  size_t number_of_entries      = 0;
+  size_t capacity_of_entries    = 0;
+  _cspec_history_entry entry;
+  FILE *file;
+  size_t id;
+
+  if(cspec->history == NULL || (file = fopen(cspec->history, "r")) == NULL) {
+    return;
+  }
+  while(_cspec_read_key(file, &entry.key, &entry.duration)) {
+    if(number_of_entries == capacity_of_entries) {
+      capacity_of_entries = capacity_of_entries ? 2 * capacity_of_entries : 64;
+      entries             = (_cspec_history_entry *)realloc(
+        entries, capacity_of_entries * sizeof(_cspec_history_entry)
+      );
+    }
+    entries[number_of_entries++] = entry;
+  }
+  fclose(file);
+
+  if(number_of_entries > 0) {
+    qsort(
+      entries,
+      number_of_entries,
+      sizeof(_cspec_history_entry),
+      _cspec_compare_keys
+    );
+  }
+  for(id = 0; id < cspec->number_of_nodes && number_of_entries > 0; id++) {
+    const _cspec_history_entry *found;
+
+    if(cspec->nodes[id].kind != CSPEC_NODE_IT) {
+      continue;
+    }
+    entry.key = _cspec_node_key(id);
+    found     = (const _cspec_history_entry *)bsearch(
+      &entry,
+      entries,
+      number_of_entries,
+      sizeof(_cspec_history_entry),
+      _cspec_compare_keys
+    );
+    if(found != NULL) {
+      cspec->nodes[id].expected = found->duration;
+    }
+  }
+  free(entries);
+}
+
+static void _cspec_write_path(FILE *file, size_t id) {
+  if(cspec->nodes[id].parent != CSPEC_NO_NODE) {
+    _cspec_write_path(file, cspec->nodes[id].parent);
+    fputc('/', file);
+  }
+  fputs(cspec->nodes[id].name, file);
+}
+
+/**
+ * @brief Writes back the duration of every test, as measured by this run
+ * or as recorded before for the tests that did not run this time
+ */
+static void _cspec_write_history(void) {
+  FILE *file;
+  size_t id;
+
+  if(cspec->history == NULL || (file = fopen(cspec->history, "w")) == NULL) {
+    return;
+  }
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    const _cspec_node *node = &cspec->nodes[id];
+    size_t duration =
+      node->duration != CSPEC_NO_DURATION ? node->duration : node->expected;
+
+    if(node->kind == CSPEC_NODE_IT && duration != CSPEC_NO_DURATION) {
+      fprintf(
+        file,
+        "%016llx %zu %s:%zu ",
+        node->hash,
+        duration,
+        node->file,
+        node->line
+      );
+      _cspec_write_path(file, id);
+      fputc('\n', file);
+    }
+  }
+  fclose(file);
+}
+
+/**
+ * @brief Marks the tests that failed in the run before, as listed in the
+ * journal. Each line is `<hash of the path> <file>:<line> <path>`. An
+ * empty journal turns CSPEC_RERUN_FAILED back into a run of everything
+ */
+static void _cspec_read_journal(void) {
+  _cspec_test_key *keys   = NULL;
+  size_t number_of_keys   = 0;
+  size_t capacity_of_keys = 0;
+  _cspec_test_key key;
+  const void *found;
+  FILE *file;
+  size_t id;
+
+  if(cspec->journal != NULL && (file = fopen(cspec->journal, "r")) != NULL) {
+    while(_cspec_read_key(file, &key, NULL)) {
+      if(number_of_keys == capacity_of_keys) {
+        capacity_of_keys = capacity_of_keys ? 2 * capacity_of_keys : 64;
+        keys             = (_cspec_test_key *)realloc(
+          keys, capacity_of_keys * sizeof(_cspec_test_key)
+        );
+      }
+      keys[number_of_keys++] = key;
+    }
+    fclose(file);
+  }
+
+  if(number_of_keys == 0) {
+    cspec->rerun_failed = _cspec_false;
+    return;
+  }
+  qsort(keys, number_of_keys, sizeof(_cspec_test_key), _cspec_compare_keys);
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    if(cspec->nodes[id].kind != CSPEC_NODE_IT) {
+      cspec->nodes[id].journaled = _cspec_false;
+      continue;
+    }
+    key   = _cspec_node_key(id);
+    found = bsearch(
+      &key, keys, number_of_keys, sizeof(_cspec_test_key), _cspec_compare_keys
+    );
+    cspec->nodes[id].journaled = found != NULL;
+  }
+  free(keys);
+}
+
+/**
+ * @brief Writes the tests that failed in this run to the journal, together
+ * with the ones that failed before and did not run this time
+ */
+static void _cspec_write_journal(void) {
+  FILE *file;
+  size_t id;
+
+  if(cspec->journal == NULL || (file = fopen(cspec->journal, "w")) == NULL) {
+    return;
+  }
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    const _cspec_node *node = &cspec->nodes[id];
+
+    if(node->failed ||
+       (node->journaled && node->duration == CSPEC_NO_DURATION)) {
+      fprintf(file, "%016llx %s:%zu ", node->hash, node->file, node->line);
+      _cspec_write_path(file, id);
+      fputc('\n', file);
+    }
+  }
+  fclose(file);
+}
+
+/**
+ * @brief The duration assumed for tests without a history, which is the
+ * average of all tests that have one
+ */
+static size_t _cspec_average_duration(void) {
+  size_t known_time  = 0;
+  size_t known_tests = 0;
+  size_t id;
+
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    if(cspec->nodes[id].kind == CSPEC_NODE_IT &&
+       cspec->nodes[id].expected != CSPEC_NO_DURATION) {
+      known_time += cspec->nodes[id].expected;
+      known_tests++;
+    }
+  }
+
+  return known_tests > 0 && known_time >= known_tests
+           ? known_time / known_tests
+           : 1;
+}
+
+/**
+ * @brief A selected test waiting to be dealt to a shard
+ */
+typedef struct {
+  size_t weight;
+  unsigned long long hash;
+  size_t id;
+} _cspec_shard_entry;
+
+static int _cspec_compare_shard_entries(const void *a, const void *b) {
+  const _cspec_shard_entry *left  = (const _cspec_shard_entry *)a;
+  const _cspec_shard_entry *right = (const _cspec_shard_entry *)b;
+
+  if(left->weight != right->weight) {
+    return left->weight < right->weight ? 1 : -1;
+  }
+  if(left->hash != right->hash) {
+    return left->hash < right->hash ? -1 : 1;
+  }
+  return left->id < right->id ? -1 : left->id > right->id;
+}
+
+/**
+ * @brief Unselects the tests of every other shard. A test belongs to the
+ * shard its path hashes to, or when balancing, to the lightest shard at
+ * the time the tests are dealt out longest first. Every machine computes
+ * the same split on its own, as long as they all read the same history
+ */
+static void _cspec_select_shard(void) {
+  _cspec_shard_entry *entries;
+  size_t *loads;
+  size_t number_of_entries = 0;
+  size_t average;
+  size_t id;
+  size_t e;
+
+  if(!cspec->balance_shards) {
+    for(id = 0; id < cspec->number_of_nodes; id++) {
+      if(cspec->nodes[id].hash % cspec->shard_count != cspec->shard_index) {
+        cspec->nodes[id].selected = 0;
+      }
+    }
+    return;
+  }
+
+  entries = (_cspec_shard_entry *)malloc(
+    (cspec->number_of_nodes + 1) * sizeof(_cspec_shard_entry)
+  );
+  loads   = (size_t *)calloc(cspec->shard_count, sizeof(size_t));
+  average = _cspec_average_duration();
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    if(cspec->nodes[id].selected) {
+      _cspec_shard_entry *entry = &entries[number_of_entries++];
+      entry->weight             = cspec->nodes[id].expected;
+      entry->hash               = cspec->nodes[id].hash;
+      entry->id                 = id;
+
+      /* Every test weighs something so that quick ones still spread out */
+      if(cspec->nodes[id].skipped || entry->weight == 0) {
+        entry->weight = 1;
+      } else if(entry->weight == CSPEC_NO_DURATION) {
+        entry->weight = average;
+      }
+    }
+  }
+  if(number_of_entries > 0) {
+    qsort(
+      entries,
+      number_of_entries,
+      sizeof(_cspec_shard_entry),
+      _cspec_compare_shard_entries
+    );
+  }
+
+  for(e = 0; e < number_of_entries; e++) {
+    size_t lightest = 0;
+    size_t shard;
+
+    for(shard = 1; shard < cspec->shard_count; shard++) {
+      if(loads[shard] < loads[lightest]) {
+        lightest = shard;
+      }
+    }
+    loads[lightest] += entries[e].weight;
+    if(lightest != cspec->shard_index) {
+      cspec->nodes[entries[e].id].selected = 0;
+    }
+  }
+
+  free(entries);
+  free(loads);
+}
+
+/**
+ * @brief Matches a whole path against a glob, where `*` stands for any
+ * run of characters, `/` included, and `?` for any single one
+ */
+static cspec_bool _cspec_matches_glob(const char *glob, const char *path) {
+  const char *star    = NULL;
+  const char *restart = NULL;
+
+  while(*path != '\0') {
+    if(*glob == '*') {
+      star    = glob++;
+      restart = path;
+    } else if(*glob != '\0' && (*glob == '?' || *glob == *path)) {
+      glob++;
+      path++;
+    } else if(star != NULL) {
+      glob = star + 1;
+      path = ++restart;
+    } else {
+      return _cspec_false;
+    }
+  }
+  while(*glob == '*') {
+    glob++;
+  }
+
+  return *glob == '\0';
+}
+
+/**
+ * @brief Marks the nodes that CSPEC_FILTER asks for. A pattern with `*` or
+ * `?` is a glob over the whole `module/describe/.../it` path, anything else
+ * is looked for as a substring of it. A node also matches when its parent
+ * does, so a pattern naming a describe takes all of its tests
+ * @param matched -> One flag per node
+ */
+static void _cspec_match_filter(cspec_bool *matched) {
+  size_t *lengths =
+    (size_t *)malloc((cspec->number_of_nodes + 1) * sizeof(size_t));
+  char *path      = NULL;
+  size_t capacity = 0;
+  cspec_bool glob = strpbrk(cspec->filter, "*?") != NULL;
+  size_t id;
+
+  /* Nodes come in source order, so the path of the parent is still in
+   * place and each node only appends its own name to it */
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    const _cspec_node *node = &cspec->nodes[id];
+    size_t offset           = 0;
+    size_t length           = strlen(node->name);
+
+    if(node->parent != CSPEC_NO_NODE) {
+      offset = lengths[node->parent] + 1;
+    }
+    if(offset + length + 1 > capacity) {
+      capacity = 2 * (offset + length + 1);
+      path     = (char *)realloc(path, capacity);
+    }
+    if(offset > 0) {
+      path[offset - 1] = '/';
+    }
+    memcpy(path + offset, node->name, length + 1);
+    lengths[id] = offset + length;
+
+    matched[id] = (node->parent != CSPEC_NO_NODE && matched[node->parent]) ||
+                  (glob ? _cspec_matches_glob(cspec->filter, path)
+                        : strstr(path, cspec->filter) != NULL);
+  }
+
+  free(lengths);
+  free(path);
+}
+
+/**
+ * @brief One alternative of a compiled CSPEC_TAGS expression, which holds
+ * for the tags that have every `required` bit and no `forbidden` one
+ */
+typedef struct {
+  unsigned long long required;
+  unsigned long long forbidden;
+} _cspec_tag_clause;
+
+/**
+ * @brief The state of the parser of a CSPEC_TAGS expression
+ * @param at -> The next character to read
+ * @param failed -> Set on a syntax error or when there are too many clauses
+ * @param unknown -> Set along with `failed` when `at` is a tag that no
+ * block declared
+ */
+typedef struct {
+  const char *at;
+  cspec_bool failed;
+  cspec_bool unknown;
+} _cspec_tag_parser;
+
+/**
+ * @brief Appends the alternatives of `right` to the ones of `left`
+ * @return The number of clauses in `left`
+ */
+static size_t _cspec_or_clauses(
+  _cspec_tag_parser *parser,
+  _cspec_tag_clause *left,
+  size_t number_of_left,
+  const _cspec_tag_clause *right,
+  size_t number_of_right
+) {
+  if(number_of_left + number_of_right > CSPEC_MAX_TAG_CLAUSES) {
+    parser->failed = _cspec_true;
+    return 0;
+  }
+  memcpy(
+    left + number_of_left, right, number_of_right * sizeof(_cspec_tag_clause)
+  );
+  return number_of_left + number_of_right;
+}
+
+/**
+ * @brief Replaces `left` with every pair of its clauses and the ones of
+ * `right`, dropping the pairs that require and forbid the same tag
+ * @return The number of clauses in `left`
+ */
+static size_t _cspec_and_clauses(
+  _cspec_tag_parser *parser,
+  _cspec_tag_clause *left,
+  size_t number_of_left,
+  const _cspec_tag_clause *right,
+  size_t number_of_right
+) {
+  _cspec_tag_clause product[CSPEC_MAX_TAG_CLAUSES];
+  size_t number_of_clauses = 0;
+  size_t l;
+  size_t r;
+
+  for(l = 0; l < number_of_left; l++) {
+    for(r = 0; r < number_of_right; r++) {
+      _cspec_tag_clause clause;
+      clause.required  = left[l].required | right[r].required;
+      clause.forbidden = left[l].forbidden | right[r].forbidden;
+
+      if(clause.required & clause.forbidden) {
+        continue;
+      }
+      if(number_of_clauses == CSPEC_MAX_TAG_CLAUSES) {
+        parser->failed = _cspec_true;
+        return 0;
+      }
+      product[number_of_clauses++] = clause;
+    }
+  }
+
+  memcpy(left, product, number_of_clauses * sizeof(_cspec_tag_clause));
+  return number_of_clauses;
+}
+
+static size_t _cspec_parse_tag_expression(
+  _cspec_tag_parser *parser, cspec_bool negated, _cspec_tag_clause *clauses
+);
+
+static void _cspec_skip_tag_spaces(_cspec_tag_parser *parser) {
+  while(*parser->at == ' ' || *parser->at == '\t') {
+    parser->at++;
+  }
+}
+
+/**
+ * @brief Parses a tag, a negation or an expression in parentheses
+ * @param negated -> Set when an odd number of `!` applies to it
+ * @return The number of clauses written to `clauses`
+ */
+static size_t _cspec_parse_tag_factor(
+  _cspec_tag_parser *parser, cspec_bool negated, _cspec_tag_clause *clauses
+) {
+  const char *name;
+  unsigned long long bit;
+  size_t number_of_clauses;
+
+  _cspec_skip_tag_spaces(parser);
+  if(*parser->at == '!') {
+    parser->at++;
+    return _cspec_parse_tag_factor(parser, !negated, clauses);
+  }
+  if(*parser->at == '(') {
+    parser->at++;
+    number_of_clauses = _cspec_parse_tag_expression(parser, negated, clauses);
+    _cspec_skip_tag_spaces(parser);
+    if(*parser->at != ')') {
+      parser->failed = _cspec_true;
+      return 0;
+    }
+    parser->at++;
+    return number_of_clauses;
+  }
+
+  if(*parser->at == ':') {
+    parser->at++;
+  }
+  name = parser->at;
+  while(_cspec_is_tag_character(*parser->at)) {
+    parser->at++;
+  }
+  if(parser->at == name) {
+    parser->failed = _cspec_true;
+    return 0;
+  }
+  /* Tags are compiled after discovery, so a name no block declared is a
+   * typo that would otherwise quietly select no tests at all */
+  if((bit = _cspec_find_tag(name, (size_t)(parser->at - name))) == 0) {
+    parser->failed  = _cspec_true;
+    parser->unknown = _cspec_true;
+    parser->at      = name;
+    return 0;
+  }
+  clauses[0].required  = negated ? 0 : bit;
+  clauses[0].forbidden = negated ? bit : 0;
+  return 1;
+}
+
+/**
+ * @brief Parses factors joined by `&`. Under a negation the factors are
+ * negated and joined as alternatives instead
+ */
+static size_t _cspec_parse_tag_term(
+  _cspec_tag_parser *parser, cspec_bool negated, _cspec_tag_clause *clauses
+) {
+  _cspec_tag_clause right[CSPEC_MAX_TAG_CLAUSES];
+  size_t number_of_clauses = _cspec_parse_tag_factor(parser, negated, clauses);
+
+  _cspec_skip_tag_spaces(parser);
+  while(!parser->failed && *parser->at == '&') {
+    size_t number_of_right;
+
+    parser->at++;
+    number_of_right   = _cspec_parse_tag_factor(parser, negated, right);
+    number_of_clauses = negated ? _cspec_or_clauses(
+                                    parser,
+                                    clauses,
+                                    number_of_clauses,
+                                    right,
+                                    number_of_right
+                                  )
+                                : _cspec_and_clauses(
+                                    parser,
+                                    clauses,
+                                    number_of_clauses,
+                                    right,
+                                    number_of_right
+                                  );
+    _cspec_skip_tag_spaces(parser);
+  }
+
+  return number_of_clauses;
+}
+
+/**
+ * @brief Parses terms joined by `|` into a list of alternatives, pushing
+ * negations down to the tags on the way
+ * @return The number of clauses written to `clauses`
+ */
+static size_t _cspec_parse_tag_expression(
+  _cspec_tag_parser *parser, cspec_bool negated, _cspec_tag_clause *clauses
+) {
+  _cspec_tag_clause right[CSPEC_MAX_TAG_CLAUSES];
+  size_t number_of_clauses = _cspec_parse_tag_term(parser, negated, clauses);
+
+  _cspec_skip_tag_spaces(parser);
+  while(!parser->failed && *parser->at == '|') {
+    size_t number_of_right;
+
+    parser->at++;
+    number_of_right   = _cspec_parse_tag_term(parser, negated, right);
+    number_of_clauses = negated ? _cspec_and_clauses(
+                                    parser,
+                                    clauses,
+                                    number_of_clauses,
+                                    right,
+                                    number_of_right
+                                  )
+                                : _cspec_or_clauses(
+                                    parser,
+                                    clauses,
+                                    number_of_clauses,
+                                    right,
+                                    number_of_right
+                                  );
+    _cspec_skip_tag_spaces(parser);
+  }
+
+  return number_of_clauses;
+}
+
+/**
+ * @brief Compiles CSPEC_TAGS, like "fast & !io" or "(unit | :slow) & !net",
+ * into alternatives of required and forbidden bits, so that checking the
+ * tags of a test is a couple of masks. An expression that cannot be read
+ * or names a tag that no block declared exits with CSPEC_EXIT_USAGE, since
+ * running every test or none of them instead would go unnoticed
+ * @return The number of clauses
+ */
+static size_t _cspec_compile_tags(_cspec_tag_clause *clauses) {
+  _cspec_tag_parser parser;
+  size_t number_of_clauses;
+
+  parser.at         = cspec->tag_expression;
+  parser.failed     = _cspec_false;
+  parser.unknown    = _cspec_false;
+  number_of_clauses =
+    _cspec_parse_tag_expression(&parser, _cspec_false, clauses);
+  _cspec_skip_tag_spaces(&parser);
+
+  if(parser.unknown) {
+    const char *end = parser.at;
+
+    while(_cspec_is_tag_character(*end)) {
+      end++;
+    }
+    printf(
+      "\n\033[1;31mNo block is tagged `%.*s` of CSPEC_TAGS `%s`\033[0m\n",
+      (int)(end - parser.at),
+      parser.at,
+      cspec->tag_expression
+    );
+    exit(CSPEC_EXIT_USAGE);
+  }
+  if(parser.failed || *parser.at != '\0') {
+    printf(
+      "\n\033[1;31mCould not read CSPEC_TAGS `%s` at `%s`\033[0m\n",
+      cspec->tag_expression,
+      parser.at
+    );
+    exit(CSPEC_EXIT_USAGE);
+  }
+  return number_of_clauses;
+}
+
+/**
+ * @brief Tells whether tags satisfy any of the compiled clauses
+ */
+static cspec_bool _cspec_matches_tags(
+  unsigned long long tags,
+  const _cspec_tag_clause *clauses,
+  size_t number_of_clauses
+) {
+  size_t c;
+
+  for(c = 0; c < number_of_clauses; c++) {
+    if((tags & clauses[c].required) == clauses[c].required &&
+       (tags & clauses[c].forbidden) == 0) {
+      return _cspec_true;
+    }
+  }
+  return _cspec_false;
+}
+
+/**
+ * @brief Decides which tests run and sums them up the tree, so that whole
+ * modules and describes without a selected test are never entered. Tests
+ * that do not match CSPEC_FILTER or CSPEC_TAGS or belong to other shards
+ * are dropped here, before any of them starts
+ */
+static void _cspec_select_tests(void) {
+  _cspec_tag_clause clauses[CSPEC_MAX_TAG_CLAUSES];
+  size_t number_of_clauses = CSPEC_NO_NODE;
+  cspec_bool *matched      = NULL;
+  size_t id;
+  size_t first = 0;
+  size_t end   = cspec->number_of_nodes;
+
+  if(cspec->selected_id != CSPEC_NO_NODE) {
+    first = cspec->selected_id;
+    end   = first < end ? cspec->nodes[first].end : first;
+  }
+
+  if(cspec->filter != NULL) {
+    matched = (cspec_bool *)malloc(cspec->number_of_nodes + 1);
+    _cspec_match_filter(matched);
+  }
+  if(cspec->tag_expression != NULL) {
+    number_of_clauses = _cspec_compile_tags(clauses);
+  }
+
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    cspec->nodes[id].selected =
+      cspec->nodes[id].kind == CSPEC_NODE_IT && id >= first && id < end &&
+      (!cspec->rerun_failed || cspec->nodes[id].journaled) &&
+      (matched == NULL || matched[id]) &&
+      (number_of_clauses == CSPEC_NO_NODE ||
+       _cspec_matches_tags(
+         cspec->nodes[id].tags, clauses, number_of_clauses
+       ));
+  }
+  free(matched);
+  if(cspec->shard_count > 1) {
+    _cspec_select_shard();
+  }
+  for(id = cspec->number_of_nodes; id > 0; id--) {
+    size_t parent = cspec->nodes[id - 1].parent;
+    if(parent != CSPEC_NO_NODE) {
+      cspec->nodes[parent].selected += cspec->nodes[id - 1].selected;
+    }
+  }
+}
+
+/**
+ * @brief A module that holds selected tests, in the order it will be printed
+ * @param weight -> The expected duration of its selected tests
+ * @param done -> Set once its report arrived or its worker died
+ * @param lost -> The wait status of the worker that died running it, or -1
+ * if it never started because of CSPEC_MAX_FAILURES
+ */
+typedef struct {
+  size_t id;
+  size_t weight;
+  cspec_bool done;
+  int lost;
+  char *output;
+  size_t output_length;
+} _cspec_scheduled_module;
+
+/**
+ * @brief Sums up the expected durations of the selected tests of every
+ * module. Tests without a history count as the average one that has
+ */
+static void _cspec_weigh_modules(
+  _cspec_scheduled_module *modules, size_t number_of_modules
+) {
+  size_t average = _cspec_average_duration();
+  size_t position;
+  size_t id;
+
+  for(position = 0; position < number_of_modules; position++) {
+    const _cspec_node *module = &cspec->nodes[modules[position].id];
+
+    modules[position].weight = 0;
+    for(id = modules[position].id + 1; id < module->end; id++) {
+      size_t expected = cspec->nodes[id].expected;
+      if(cspec->nodes[id].kind == CSPEC_NODE_IT && cspec->nodes[id].selected) {
+        modules[position].weight +=
+          expected != CSPEC_NO_DURATION ? expected : average;
+      }
+    }
+  }
+}
+
+/**
+ * @brief A splitmix64 generator, which is all the shuffles need
+ * @param state -> Advanced on every call
+ * @return The next pseudo random number
+ */
+static unsigned long long _cspec_next_random(unsigned long long *state) {
+  unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+  z                    = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z                    = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * @brief Shuffles the selected children of a node among each other, then
+ * the children of every describe in turn, so that the tests of a describe
+ * still run one after the other
+ * @param id -> The module or describe whose tests are shuffled
+ * @param targets -> Gets the tests in the order they will run
+ * @param number_of_targets -> The number of tests in `targets` so far
+ * @param state -> The state of the generator
+ */
+static void _cspec_shuffle_tests(
+  size_t id,
+  size_t *targets,
+  size_t *number_of_targets,
+  unsigned long long *state
+) {
+  size_t *children = (size_t *)malloc(
+    (cspec->nodes[id].end - id) * sizeof(size_t)
+  );
+  size_t number_of_children = 0;
+  size_t child;
+
+  for(child = id + 1; child < cspec->nodes[id].end;
+      child = cspec->nodes[child].end) {
+    if(cspec->nodes[child].selected > 0) {
+      children[number_of_children++] = child;
+    }
+  }
+  for(child = number_of_children; child > 1; child--) {
+    size_t other        = (size_t)(_cspec_next_random(state) % child);
+    size_t swapped      = children[child - 1];
+    children[child - 1] = children[other];
+    children[other]     = swapped;
+  }
+
+  for(child = 0; child < number_of_children; child++) {
+    if(cspec->nodes[children[child]].kind == CSPEC_NODE_IT) {
+      targets[(*number_of_targets)++] = children[child];
+    } else {
+      _cspec_shuffle_tests(children[child], targets, number_of_targets, state);
+    }
+  }
+  free(children);
+}
+
+/**
+ * @brief Runs the selected tests of a module. With CSPEC_ORDER=random its
+ * describes and its are shuffled, and the module function is walked once
+ * for every test in that order. Each walk only enters the blocks on the way
+ * to its test and runs their `before` and `after` again, since the locals
+ * they set up live in the frame of that walk. Headers print on the first
+ * walk through their block
+ * @param id -> The module
+ */
+static void _cspec_run_module(size_t id) {
+  unsigned long long state = cspec->seed ^ cspec->nodes[id].hash;
+  size_t number_of_targets = 0;
+  size_t *targets;
+  size_t t;
+
+  if(!cspec->random_order) {
+    cspec->next_node = id;
+    cspec->nodes[id].function();
+    return;
+  }
+
+  targets =
+    (size_t *)malloc((cspec->nodes[id].selected + 1) * sizeof(size_t));
+  _cspec_shuffle_tests(id, targets, &number_of_targets, &state);
+  for(t = 0; t < number_of_targets && !_cspec_reached_max_failures(); t++) {
+    cspec->previous_target = t > 0 ? targets[t - 1] : CSPEC_NO_NODE;
+    cspec->walk_target     = targets[t];
+    cspec->next_node       = id;
+    cspec->nodes[id].function();
+  }
+  cspec->previous_target = CSPEC_NO_NODE;
+  cspec->walk_target     = CSPEC_NO_NODE;
+  free(targets);
+}
+
+#if defined(CSPEC_HAS_FORK) || defined(CSPEC_THREAD_POOL)
+/**
+ * @brief The modules a worker owns, as a range of the schedule. The owner
+ * takes from the head, which holds its longest module, while idle workers
+ * steal from the tail
+ */
+typedef struct {
+  size_t head;
+  size_t tail;
+  #if defined(CSPEC_THREAD_POOL)
+  pthread_mutex_t lock;
+  #endif
+} _cspec_deque;
+
+/**
+ * @param positions -> The backing storage of every deque
+ * @param deques -> One deque per worker
+ * @param failures -> The failing tests of every module that finished, so
+ * that no more modules are handed out past CSPEC_MAX_FAILURES
+ */
+typedef struct {
+  size_t *positions;
+  _cspec_deque *deques;
+  size_t number_of_deques;
+  size_t failures;
+  #if defined(CSPEC_THREAD_POOL)
+  pthread_mutex_t lock;
+  #endif
+} _cspec_schedule;
+
+  #if defined(CSPEC_THREAD_POOL)
+    #define _cspec_lock(object)   pthread_mutex_lock(&(object)->lock)
+    #define _cspec_unlock(object) pthread_mutex_unlock(&(object)->lock)
+  #else
+    #define _cspec_lock(object)
+    #define _cspec_unlock(object)
+  #endif
+
+static int _cspec_compare_weights(const void *a, const void *b) {
+  const _cspec_scheduled_module *left =
+    *(const _cspec_scheduled_module *const *)a;
+  const _cspec_scheduled_module *right =
+    *(const _cspec_scheduled_module *const *)b;
+
+  if(left->weight != right->weight) {
+    return left->weight < right->weight ? 1 : -1;
+  }
+  return left < right ? -1 : left > right;
+}
+
+/**
+ * @brief Deals the modules out longest first, going back and forth over
+ * the workers, so that every deque is sorted from its longest module to
+ * its shortest and all of them start with about the same amount of work
+ */
+static void _cspec_build_schedule(
+  _cspec_schedule *schedule,
+  _cspec_scheduled_module *modules,
+  size_t number_of_modules,
+  size_t workers
+) {
+  _cspec_scheduled_module **sorted = (_cspec_scheduled_module **)malloc(
+    number_of_modules * sizeof(_cspec_scheduled_module *)
+  );
+  size_t start = 0;
+  size_t k;
+  size_t w;
+
+  schedule->positions = (size_t *)malloc(number_of_modules * sizeof(size_t));
+  schedule->deques    = (_cspec_deque *)malloc(workers * sizeof(_cspec_deque));
+  schedule->number_of_deques = workers;
+  schedule->failures         = 0;
+  #if defined(CSPEC_THREAD_POOL)
+  pthread_mutex_init(&schedule->lock, NULL);
+  #endif
+
+  for(k = 0; k < number_of_modules; k++) {
+    sorted[k] = &modules[k];
+  }
+  qsort(
+    sorted,
+    number_of_modules,
+    sizeof(_cspec_scheduled_module *),
+    _cspec_compare_weights
+  );
+
+  for(w = 0; w < workers; w++) {
+    schedule->deques[w].head = start;
+    schedule->deques[w].tail = start;
+    for(k = 0; k < number_of_modules; k++) {
+      size_t row    = k / workers;
+      size_t column = row % 2 == 0 ? k % workers : workers - 1 - k % workers;
+      if(column == w) {
+        schedule->positions[schedule->deques[w].tail++] =
+          (size_t)(sorted[k] - modules);
+      }
+    }
+    start = schedule->deques[w].tail;
+  #if defined(CSPEC_THREAD_POOL)
+    pthread_mutex_init(&schedule->deques[w].lock, NULL);
+  #endif
+  }
+
+  free(sorted);
+}
+
+static void _cspec_free_schedule(_cspec_schedule *schedule) {
+  #if defined(CSPEC_THREAD_POOL)
+  size_t w;
+  for(w = 0; w < schedule->number_of_deques; w++) {
+    pthread_mutex_destroy(&schedule->deques[w].lock);
+  }
+  pthread_mutex_destroy(&schedule->lock);
+  #endif
+  free(schedule->positions);
+  free(schedule->deques);
+}
+
+/**
+ * @brief Adds the failing tests of a module that finished to the schedule
+ */
+static void _cspec_count_failures(_cspec_schedule *schedule, size_t failures) {
+  _cspec_lock(schedule);
+  schedule->failures += failures;
+  _cspec_unlock(schedule);
+}
+
+/**
+ * @brief Takes the longest module left for a worker, stealing the shortest
+ * one of the next worker that still has some once its own deque is empty
+ * @return The position of the module, or CSPEC_NO_NODE when all are taken
+ * or the modules that finished reached CSPEC_MAX_FAILURES
+ */
+static size_t _cspec_next_module(_cspec_schedule *schedule, size_t worker) {
+  size_t position = CSPEC_NO_NODE;
+  size_t failures;
+  size_t i;
+
+  _cspec_lock(schedule);
+  failures = schedule->failures;
+  _cspec_unlock(schedule);
+  if(cspec->max_failures > 0 && failures >= cspec->max_failures) {
+    return CSPEC_NO_NODE;
+  }
+
+  for(i = 0; i < schedule->number_of_deques && position == CSPEC_NO_NODE;
+      i++) {
+    _cspec_deque *deque =
+      &schedule->deques[(worker + i) % schedule->number_of_deques];
+
+    _cspec_lock(deque);
+    if(deque->head < deque->tail) {
+      position = i == 0 ? schedule->positions[deque->head++]
+                        : schedule->positions[--deque->tail];
+    }
+    _cspec_unlock(deque);
+  }
+
+  return position;
+}
+#endif
+
+#if defined(CSPEC_HAS_FORK)
+/**
+ * @brief What a worker sends up its pipe after each module. It is followed
+ * by `output_length` bytes of everything that module printed, and by
+ * `number_of_durations` triples of test id, measured duration and whether
+ * the test failed
+ * @param position -> The index of the module in the list of scheduled ones
+ * @param output_length -> The number of bytes of output that follow
+ * @param number_of_durations -> The number of tests that were timed
+ */
+typedef struct {
+  size_t position;
+  size_t number_of_tests;
+  size_t number_of_passing_tests;
+  size_t number_of_failing_tests;
+  size_t number_of_skipped_tests;
+  size_t total_time_taken_for_tests;
+  size_t high_water_mark;
+  size_t number_of_mallocs;
+  size_t output_length;
+  size_t number_of_durations;
+} _cspec_module_report;
+
+/**
+ * @brief A forked worker as seen by the parent
+ * @param pid -> The process id of the worker
+ * @param fd -> The read end of its report pipe, -1 once it is closed
+ * @param commands -> The write end of the pipe it takes modules from
+ * @param position -> The module it is running, or CSPEC_NO_NODE
+ * @param buffer -> Bytes received that do not form a whole report yet
+ */
+typedef struct {
+  pid_t pid;
+  int fd;
+  int commands;
+  size_t position;
+  char *buffer;
+  size_t size;
+  size_t capacity;
+} _cspec_worker;
+
+static void _cspec_write_all(int fd, const char *data, size_t length) {
+  while(length > 0) {
+    ssize_t written = write(fd, data, length);
+    if(written < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      _exit(1);
+    }
+    data += written;
+    length -= (size_t)written;
+  }
+}
+
+/**
+ * @brief Runs the modules the parent hands out, one at a time, inside of a
+ * forked child. Standard output goes to a temporary file that is sent to
+ * the parent after each module, so that nothing interleaves
+ * @param commands -> The read end of the pipe positions arrive on
+ * @param fd -> The write end of the pipe to the parent
+ */
+static void _cspec_run_worker(
+  int commands, int fd, const _cspec_scheduled_module *modules
+) {
+  FILE *capture        = tmpfile();
+  char *output         = NULL;
+  size_t capacity      = 0;
+  size_t *durations    = NULL;
+  size_t max_durations = 0;
+  size_t position;
+
+  if(capture == NULL || dup2(fileno(capture), STDOUT_FILENO) < 0) {
+    _exit(1);
+  }
+
+  while(read(commands, &position, sizeof(position)) == sizeof(position)) {
+    const _cspec_node *module = &cspec->nodes[modules[position].id];
+    _cspec_module_report report;
+    size_t number_of_durations = 0;
+    size_t received            = 0;
+    size_t id;
+    off_t length;
+
+    /* The counters keep adding up so that CSPEC_MAX_FAILURES also holds
+     * inside of the worker, the report only carries what this module added */
+    report.number_of_tests            = cspec->number_of_tests;
+    report.number_of_passing_tests    = cspec->number_of_passing_tests;
+    report.number_of_failing_tests    = cspec->number_of_failing_tests;
+    report.number_of_skipped_tests    = cspec->number_of_skipped_tests;
+    report.total_time_taken_for_tests = cspec->total_time_taken_for_tests;
+    report.number_of_mallocs          = cspec->arena.number_of_mallocs;
+    _cspec_run_module(modules[position].id);
+
+    fflush(stdout);
+    length = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+    if(length < 0 || lseek(STDOUT_FILENO, 0, SEEK_SET) < 0) {
+      _exit(1);
+    }
+    if((size_t)length > capacity) {
+      capacity = (size_t)length;
+      output   = (char *)realloc(output, capacity);
+    }
+    while(received < (size_t)length) {
+      ssize_t bytes =
+        read(STDOUT_FILENO, output + received, (size_t)length - received);
+      if(bytes <= 0) {
+        _exit(1);
+      }
+      received += (size_t)bytes;
+    }
+    lseek(STDOUT_FILENO, 0, SEEK_SET);
+
+    if(module->end - modules[position].id > max_durations) {
+      max_durations = module->end - modules[position].id;
+      durations =
+        (size_t *)realloc(durations, 3 * max_durations * sizeof(size_t));
+    }
+    for(id = modules[position].id + 1; id < module->end; id++) {
+      if(cspec->nodes[id].duration != CSPEC_NO_DURATION) {
+        durations[3 * number_of_durations]     = id;
+        durations[3 * number_of_durations + 1] = cspec->nodes[id].duration;
+        durations[3 * number_of_durations + 2] = cspec->nodes[id].failed;
+        number_of_durations++;
+      }
+    }
+
+    report.position = position;
+    report.number_of_tests = cspec->number_of_tests - report.number_of_tests;
+    report.number_of_passing_tests =
+      cspec->number_of_passing_tests - report.number_of_passing_tests;
+    report.number_of_failing_tests =
+      cspec->number_of_failing_tests - report.number_of_failing_tests;
+    report.number_of_skipped_tests =
+      cspec->number_of_skipped_tests - report.number_of_skipped_tests;
+    report.total_time_taken_for_tests =
+      cspec->total_time_taken_for_tests - report.total_time_taken_for_tests;
+    report.high_water_mark = cspec->arena.high_water_mark;
+    report.number_of_mallocs =
+      cspec->arena.number_of_mallocs - report.number_of_mallocs;
+    report.output_length              = received;
+    report.number_of_durations        = number_of_durations;
+    _cspec_write_all(fd, (const char *)&report, sizeof(report));
+    _cspec_write_all(fd, output, received);
+    _cspec_write_all(
+      fd,
+      (const char *)durations,
+      3 * number_of_durations * sizeof(size_t)
+    );
+  }
+
+  _exit(0);
+}
+
+/**
+ * @brief Hands the next module to a worker, or closes its command pipe so
+ * that it exits once nothing is left
+ */
+static void _cspec_dispatch_module(
+  _cspec_worker *worker, _cspec_schedule *schedule, size_t w
+) {
+  worker->position = _cspec_next_module(schedule, w);
+  if(worker->position != CSPEC_NO_NODE) {
+    if(write(worker->commands, &worker->position, sizeof(size_t)) ==
+       sizeof(size_t)) {
+      return;
+    }
+    /* The worker is gone, its module is lost along with it */
+  }
+  close(worker->commands);
+  worker->commands = -1;
+}
+
+/**
+ * @brief Moves every whole report out of the buffer of a worker, merges
+ * its counters into the suite and gives the worker its next module
+ */
+static void _cspec_receive_reports(
+  _cspec_worker *worker,
+  _cspec_scheduled_module *modules,
+  _cspec_schedule *schedule,
+  size_t w
+) {
+  size_t consumed = 0;
+
+  while(worker->size - consumed >= sizeof(_cspec_module_report)) {
+    _cspec_module_report report;
+    _cspec_scheduled_module *module;
+    const char *durations;
+    size_t d;
+
+    memcpy(&report, worker->buffer + consumed, sizeof(report));
+    if(worker->size - consumed - sizeof(report) <
+       report.output_length +
+         3 * report.number_of_durations * sizeof(size_t)) {
+      break;
+    }
+    consumed += sizeof(report);
+
+    module                = &modules[report.position];
+    module->done          = _cspec_true;
+    module->output        = (char *)malloc(report.output_length + 1);
+    module->output_length = report.output_length;
+    memcpy(module->output, worker->buffer + consumed, report.output_length);
+    consumed += report.output_length;
+
+    durations = worker->buffer + consumed;
+    for(d = 0; d < report.number_of_durations; d++) {
+      size_t result[3];
+      memcpy(result, durations + d * sizeof(result), sizeof(result));
+      cspec->nodes[result[0]].duration = result[1];
+      cspec->nodes[result[0]].failed   = (cspec_bool)result[2];
+    }
+    consumed += 3 * report.number_of_durations * sizeof(size_t);
+
+    cspec->number_of_tests += report.number_of_tests;
+    cspec->number_of_passing_tests += report.number_of_passing_tests;
+    cspec->number_of_failing_tests += report.number_of_failing_tests;
+    cspec->number_of_skipped_tests += report.number_of_skipped_tests;
+    cspec->total_time_taken_for_tests += report.total_time_taken_for_tests;
+    if(report.high_water_mark > cspec->arena.high_water_mark) {
+      cspec->arena.high_water_mark = report.high_water_mark;
+    }
+    cspec->arena.number_of_mallocs += report.number_of_mallocs;
+
+    _cspec_count_failures(schedule, report.number_of_failing_tests);
+    _cspec_dispatch_module(worker, schedule, w);
+  }
+
+  worker->size -= consumed;
+  memmove(worker->buffer, worker->buffer + consumed, worker->size);
+}
+
+/**
+ * @brief Marks a module as lost with the wait status of its dead worker
+ * and counts all of its selected tests as failing
+ */
+static void _cspec_lose_module(_cspec_scheduled_module *module, int status) {
+  size_t id;
+
+  module->done = _cspec_true;
+  module->lost = status;
+  for(id = module->id + 1; id < cspec->nodes[module->id].end; id++) {
+    if(cspec->nodes[id].kind == CSPEC_NODE_IT && cspec->nodes[id].selected) {
+      cspec->nodes[id].failed = _cspec_true;
+    }
+  }
+  cspec->number_of_tests += cspec->nodes[module->id].selected;
+  cspec->number_of_failing_tests += cspec->nodes[module->id].selected;
+}
+
+/**
+ * @brief Prints the modules that are done, stopping at the first one that
+ * is still running so the output keeps the order of discovery
+ * @return The position of the first module that was not printed
+ */
+static size_t _cspec_print_modules(
+  _cspec_scheduled_module *modules, size_t number_of_modules, size_t position
+) {
+  for(; position < number_of_modules && modules[position].done; position++) {
+    _cspec_scheduled_module *module = &modules[position];
+
+    if(module->output != NULL) {
+      fwrite(module->output, 1, module->output_length, stdout);
+      free(module->output);
+      module->output = NULL;
+    } else if(module->lost < 0) {
+      continue;
+    } else if(WIFSIGNALED(module->lost)) {
+      printf(
+        "\n%s✗ Module `%s` was lost, its worker was killed by signal %d%s\n",
+        cspec->RED,
+        cspec->nodes[module->id].name,
+        WTERMSIG(module->lost),
+        cspec->RESET
+      );
+    } else {
+      printf(
+        "\n%s✗ Module `%s` was lost, its worker exited with status %d%s\n",
+        cspec->RED,
+        cspec->nodes[module->id].name,
+        WEXITSTATUS(module->lost),
+        cspec->RESET
+      );
+    }
+  }
+
+  fflush(stdout);
+  return position;
+}
+
+/**
+ * @brief Spreads the modules over `cspec->jobs` forked workers. The parent
+ * keeps the deques of every worker and hands out one module at a time, so
+ * a worker that runs dry steals from the others. The reports coming up the
+ * pipes are merged and printed in order. The tests of a module whose
+ * worker died while running it are counted as failing
+ * @return False when not a single worker could be started, leaving every
+ * module to run in this process
+ */
+static cspec_bool _cspec_run_modules_in_parallel(
+  _cspec_scheduled_module *modules, size_t number_of_modules
+) {
+  size_t jobs = cspec->jobs < number_of_modules ? cspec->jobs
+                                                : number_of_modules;
+  _cspec_worker *workers =
+    (_cspec_worker *)malloc(jobs * sizeof(_cspec_worker));
+  struct pollfd *fds = (struct pollfd *)malloc(jobs * sizeof(struct pollfd));
+  void (*previous_handler)(int) = signal(SIGPIPE, SIG_IGN);
+  int last_status               = 0;
+  size_t printed                = 0;
+  size_t running                = 0;
+  _cspec_schedule schedule;
+  size_t position;
+  size_t w;
+
+  _cspec_build_schedule(&schedule, modules, number_of_modules, jobs);
+
+  fflush(stdout);
+  for(w = 0; w < jobs; w++) {
+    int results[2];
+    int commands[2];
+
+    workers[w].pid      = -1;
+    workers[w].fd       = -1;
+    workers[w].commands = -1;
+    workers[w].position = CSPEC_NO_NODE;
+    workers[w].buffer   = NULL;
+    workers[w].size     = 0;
+    workers[w].capacity = 0;
+    if(pipe(results) < 0) {
+      continue;
+    }
+    if(pipe(commands) < 0) {
+      close(results[0]);
+      close(results[1]);
+      continue;
+    }
+
+    workers[w].pid = fork();
+    if(workers[w].pid == 0) {
+      size_t sibling;
+
+      /* Command pipes only reach EOF once no other process holds them */
+      for(sibling = 0; sibling < w; sibling++) {
+        close(workers[sibling].fd);
+        close(workers[sibling].commands);
+      }
+      close(results[0]);
+      close(commands[1]);
+      _cspec_run_worker(commands[0], results[1], modules);
+    }
+    close(results[1]);
+    close(commands[0]);
+    if(workers[w].pid < 0) {
+      close(results[0]);
+      close(commands[1]);
+      continue;
+    }
+    workers[w].fd       = results[0];
+    workers[w].commands = commands[1];
+    running++;
+  }
+
+  if(running == 0) {
+    free(workers);
+    free(fds);
+    _cspec_free_schedule(&schedule);
+    signal(SIGPIPE, previous_handler);
+    return _cspec_false;
+  }
+
+  for(w = 0; w < jobs; w++) {
+    if(workers[w].commands >= 0) {
+      _cspec_dispatch_module(&workers[w], &schedule, w);
+    }
+  }
+
+  while(running > 0) {
+    /* poll skips the negative descriptors of finished workers */
+    for(w = 0; w < jobs; w++) {
+      fds[w].fd      = workers[w].fd;
+      fds[w].events  = POLLIN;
+      fds[w].revents = 0;
+    }
+    if(poll(fds, (nfds_t)jobs, -1) < 0 && errno != EINTR) {
+      break;
+    }
+
+    for(w = 0; w < jobs; w++) {
+      _cspec_worker *worker = &workers[w];
+      ssize_t bytes;
+
+      if(worker->fd < 0 || fds[w].revents == 0) {
+        continue;
+      }
+      if(worker->capacity - worker->size < 65536) {
+        worker->capacity = 2 * worker->capacity + 65536;
+        worker->buffer   = (char *)realloc(worker->buffer, worker->capacity);
+      }
+      bytes = read(
+        worker->fd,
+        worker->buffer + worker->size,
+        worker->capacity - worker->size
+      );
+      if(bytes < 0 && errno == EINTR) {
+        continue;
+      }
+      if(bytes > 0) {
+        worker->size += (size_t)bytes;
+        _cspec_receive_reports(worker, modules, &schedule, w);
+        continue;
+      }
+
+      close(worker->fd);
+      worker->fd = -1;
+      if(worker->commands >= 0) {
+        close(worker->commands);
+        worker->commands = -1;
+      }
+      waitpid(worker->pid, &last_status, 0);
+      worker->pid = -1;
+      if(worker->position != CSPEC_NO_NODE) {
+        _cspec_lose_module(&modules[worker->position], last_status);
+        _cspec_count_failures(
+          &schedule, cspec->nodes[modules[worker->position].id].selected
+        );
+      }
+      running--;
+    }
+
+    printed = _cspec_print_modules(modules, number_of_modules, printed);
+  }
+
+  /* Whatever was never handed out is lost with the last worker, unless
+   * it was held back because of CSPEC_MAX_FAILURES */
+  for(position = 0; position < number_of_modules; position++) {
+    if(modules[position].done) {
+      continue;
+    }
+    if(_cspec_reached_max_failures()) {
+      modules[position].done = _cspec_true;
+      modules[position].lost = -1;
+    } else {
+      _cspec_lose_module(&modules[position], last_status);
+    }
+  }
+  _cspec_print_modules(modules, number_of_modules, printed);
+
+  for(w = 0; w < jobs; w++) {
+    free(workers[w].buffer);
+  }
+  free(workers);
+  free(fds);
+  _cspec_free_schedule(&schedule);
+  signal(SIGPIPE, previous_handler);
+  return _cspec_true;
+}
+#endif
+
+#if defined(CSPEC_THREAD_POOL)
+/**
+ * @brief A thread of the pool together with the context it runs tests in
+ * @param context -> A copy of the suite context with its own counters,
+ * arena and output, so that running a test never takes a lock
+ * @param started -> Set when the thread was created and has to be joined
+ * @param worker -> The deque of the schedule this thread owns
+ */
+typedef struct {
+  _cspec_data_struct context;
+  pthread_t thread;
+  cspec_bool started;
+  _cspec_scheduled_module *modules;
+  _cspec_schedule *schedule;
+  size_t worker;
+} _cspec_pool_thread;
+
+/**
+ * @brief Runs modules from the schedule until none are left, handing the
+ * output of each one over to its scheduled module
+ */
+static void *_cspec_run_pool_thread(void *argument) {
+  _cspec_pool_thread *self = (_cspec_pool_thread *)argument;
+  size_t position;
+
+  cspec = &self->context;
+  while((position = _cspec_next_module(self->schedule, self->worker)) !=
+        CSPEC_NO_NODE) {
+    _cspec_scheduled_module *module = &self->modules[position];
+    size_t failures                 = cspec->number_of_failing_tests;
+
+    _cspec_run_module(module->id);
+    _cspec_count_failures(
+      self->schedule, cspec->number_of_failing_tests - failures
+    );
+
+    module->output         = cspec->output;
+    module->output_length  = cspec->output_size;
+    module->done           = _cspec_true;
+    cspec->output          = NULL;
+    cspec->output_size     = 0;
+    cspec->output_capacity = 0;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Spreads the modules over `cspec->threads` threads that take their
+ * work from the schedule. Each thread only touches its own context, which
+ * are summed up and printed in discovery order once all of them joined.
+ * Tests write their durations to their own node of the shared tree
+ */
+static void _cspec_run_modules_on_threads(
+  _cspec_scheduled_module *modules, size_t number_of_modules
+) {
+  _cspec_data_struct *suite = cspec;
+  size_t threads            = suite->threads < number_of_modules
+                                ? suite->threads
+                                : number_of_modules;
+  _cspec_pool_thread *pool =
+    (_cspec_pool_thread *)malloc(threads * sizeof(_cspec_pool_thread));
+  _cspec_schedule schedule;
+  size_t t;
+
+  _cspec_build_schedule(&schedule, modules, number_of_modules, threads);
+
+  /* The timer initializes itself on its first call, not on a pool thread */
+  (void)cspec_timer();
+  for(t = 0; t < threads; t++) {
+    _cspec_data_struct *context = &pool[t].context;
+
+    *context                            = *suite;
+    context->number_of_tests            = 0;
+    context->number_of_passing_tests    = 0;
+    context->number_of_failing_tests    = 0;
+    context->number_of_skipped_tests    = 0;
+    context->total_time_taken_for_tests = 0;
+    context->test_result_message        = NULL;
+    context->current_actual             = NULL;
+    context->current_expected           = NULL;
+    context->position_in_file           = NULL;
+    context->buffering                  = _cspec_true;
+    context->output                     = NULL;
+    context->output_size                = 0;
+    context->output_capacity            = 0;
+    _cspec_arena_initialize(&context->arena);
+
+    pool[t].modules  = modules;
+    pool[t].schedule = &schedule;
+    pool[t].worker   = t;
+    pool[t].started  = !pthread_create(
+      &pool[t].thread, NULL, _cspec_run_pool_thread, &pool[t]
+    );
+  }
+
+  /* The share of a thread that could not be created runs right here */
+  for(t = 0; t < threads; t++) {
+    if(pool[t].started) {
+      pthread_join(pool[t].thread, NULL);
+    } else {
+      _cspec_run_pool_thread(&pool[t]);
+    }
+  }
+  cspec = suite;
+
+  for(t = 0; t < threads; t++) {
+    _cspec_data_struct *context = &pool[t].context;
+
+    cspec->number_of_tests += context->number_of_tests;
+    cspec->number_of_passing_tests += context->number_of_passing_tests;
+    cspec->number_of_failing_tests += context->number_of_failing_tests;
+    cspec->number_of_skipped_tests += context->number_of_skipped_tests;
+    cspec->total_time_taken_for_tests += context->total_time_taken_for_tests;
+    if(context->arena.high_water_mark > cspec->arena.high_water_mark) {
+      cspec->arena.high_water_mark = context->arena.high_water_mark;
+    }
+    cspec->arena.number_of_mallocs += context->arena.number_of_mallocs;
+    _cspec_arena_release(&context->arena);
+  }
+  for(t = 0; t < number_of_modules; t++) {
+    fwrite(modules[t].output, 1, modules[t].output_length, stdout);
+    free(modules[t].output);
+  }
+
+  free(pool);
+  _cspec_free_schedule(&schedule);
+}
+#endif
+
+/**
+ * @brief Counts a test that finished and prints its result
+ * @param name -> The name of the test
+ * @param display_tab -> The indentation the test is printed with
+ * @param status -> Either CSPEC_PASSING|CSPEC_FAILING
+ * @param message -> The failed assertions of the test
+ * @param id -> The node of the test
+ * @param duration -> The time the test body took
+ */
+static void _cspec_record_test(
+  const char *name,
+  const char *display_tab,
+  cspec_bool status,
+  const char *message,
+  size_t id,
+  size_t duration
+) {
+  if(status == CSPEC_PASSING) {
+    cspec->number_of_passing_tests++;
+    if(cspec->display_filter & CSPEC_DISPLAY_PASSING) {
+      _cspec_printf(
+        "%s%s✓%s it %s%s\n",
+        display_tab,
+        cspec->GREEN,
+        cspec->RESET,
+        name,
+        cspec->RESET
+      );
+    }
+  } else {
+    /* Even if 1 of the asserts in the current it block fails, assume we
+     * have a failing test */
+    cspec->number_of_failing_tests++;
+    if(cspec->display_filter & CSPEC_DISPLAY_FAILING) {
+      _cspec_printf(
+        "%s%s✗%s it %s:\n%s%s\n",
+        display_tab,
+        cspec->RED,
+        cspec->RESET,
+        name,
+        message,
+        cspec->RESET
+      );
+    }
+  }
+
+  cspec->total_time_taken_for_tests += duration;
+  cspec->nodes[id].duration = duration;
+  cspec->nodes[id].failed   = status != CSPEC_PASSING;
+}
+
+#if defined(CSPEC_HAS_FORK)
+/**
+ * @brief What a forked child sends up its pipe after each of its tests,
+ * followed by `message_length` bytes of failed assertions
+ * @param id -> The node of the test
+ * @param high_water_mark -> The arena high-water mark of the child so far
+ * @param message_length -> The number of bytes of the message that follow
+ */
+typedef struct {
+  size_t id;
+  size_t duration;
+  size_t high_water_mark;
+  size_t message_length;
+  cspec_bool status;
+} _cspec_test_report;
+
+/**
+ * @brief Sends the result of the test that ran in this child
+ * @param duration -> The time the test body took
+ */
+static void _cspec_send_test_report(size_t duration) {
+  const char *message =
+    cspec->test_result_message ? cspec->test_result_message : "";
+  _cspec_test_report report;
+
+  report.id              = cspec->current_test;
+  report.duration        = duration;
+  report.high_water_mark = cspec->arena.high_water_mark;
+  report.message_length  = strlen(message);
+  report.status          = cspec->status_of_test;
+  _cspec_write_all(cspec->report_fd, (const char *)&report, sizeof(report));
+  _cspec_write_all(cspec->report_fd, message, report.message_length);
+}
+
+#if defined(CSPEC_HAS_SIGNALS)
+/**
+ * @brief Names the signal a test crashed with
+ * @param signal_number -> The signal that stopped the child
+ * @return NULL for signals that are not a crash
+ */
+static const char *_cspec_signal_name(int signal_number) {
+  switch(signal_number) {
+    case SIGSEGV:
+      return "SIGSEGV";
+    case SIGBUS:
+      return "SIGBUS";
+    case SIGFPE:
+      return "SIGFPE";
+    case SIGILL:
+      return "SIGILL";
+    case SIGABRT:
+      return "SIGABRT";
+    default:
+      return NULL;
+  }
+}
+
+/**
+ * @brief Kills the children whose test ran past the limit of its batch
+ * @return The milliseconds until the nearest deadline, or -1 for none
+ */
+static int _cspec_kill_late_batches(void) {
+  size_t now  = cspec_timer();
+  int nearest = -1;
+  size_t b;
+
+  for(b = 0; b < cspec->number_of_isolated; b++) {
+    _cspec_isolated_batch *batch = &cspec->isolated[b];
+    size_t left;
+
+    if(batch->done || batch->timed_out || batch->deadline == 0) {
+      continue;
+    }
+    if(now >= batch->deadline) {
+      kill(batch->pid, SIGKILL);
+      batch->timed_out = _cspec_true;
+      continue;
+    }
+    /* Rounded up, so that the poll never wakes before the deadline */
+    left = (batch->deadline - now + 999999) / 1000000;
+    if(left > INT_MAX) {
+      left = INT_MAX;
+    }
+    if(nearest < 0 || (int)left < nearest) {
+      nearest = (int)left;
+    }
+  }
+  return nearest;
+}
+#else
+  #define _cspec_kill_late_batches() (-1)
+#endif
+
+/**
+ * @brief Fails a test of a batch whose child died before reporting it
+ * @param batch -> The batch of the test
+ * @param id -> The node of the test
+ * @param first -> Set for the test the child died in
+ */
+static void _cspec_record_lost_test(
+  const _cspec_isolated_batch *batch, size_t id, cspec_bool first
+) {
+  const _cspec_node *node = &cspec->nodes[id];
+  char *message           = NULL;
+
+  _cspec_string_addf(
+    message,
+    "%s%s    %s:%zu:\n%s        |> %s",
+    batch->display_tab,
+    cspec->RESET,
+    node->file,
+    node->line,
+    batch->display_tab,
+    cspec->RED
+  );
+  if(!first) {
+    _cspec_string_addf(message, "%s", "did not run, its batch ended early");
+  } else if(batch->timed_out) {
+    _cspec_string_addf(message, "timed out after %zu ms", batch->limit);
+#if defined(CSPEC_HAS_SIGNALS)
+  } else if(WIFSIGNALED(batch->status) &&
+            _cspec_signal_name(WTERMSIG(batch->status)) != NULL) {
+    _cspec_string_addf(
+      message,
+      "crashed with %s (signal %d)",
+      _cspec_signal_name(WTERMSIG(batch->status)),
+      WTERMSIG(batch->status)
+    );
+#endif
+  } else if(WIFSIGNALED(batch->status)) {
+    _cspec_string_addf(
+      message, "was killed by signal %d", WTERMSIG(batch->status)
+    );
+  } else {
+    _cspec_string_addf(
+      message, "exited with status %d", WEXITSTATUS(batch->status)
+    );
+  }
+  _cspec_string_addf(message, "%s\n", cspec->RESET);
+  _cspec_record_test(
+    node->name, batch->display_tab, CSPEC_FAILING, message, id, 0
+  );
+}
+
+/**
+ * @brief Counts and prints the tests of a batch from the reports its child
+ * sent, failing the ones it died before reporting
+ */
+static void _cspec_record_batch(_cspec_isolated_batch *batch) {
+  cspec_bool lost = _cspec_false;
+  size_t consumed = 0;
+  size_t t;
+
+  for(t = 0; t < batch->number_of_tests; t++) {
+    size_t id = batch->ids[t];
+    _cspec_test_report report;
+    char *message;
+    char terminator;
+
+    if(lost || batch->size - consumed < sizeof(report)) {
+      _cspec_record_lost_test(batch, id, !lost);
+      lost = _cspec_true;
+      continue;
+    }
+    memcpy(&report, batch->buffer + consumed, sizeof(report));
+    if(report.id != id ||
+       batch->size - consumed - sizeof(report) < report.message_length) {
+      _cspec_record_lost_test(batch, id, !lost);
+      lost = _cspec_true;
+      continue;
+    }
+
+    /* Messages are not terminated on the pipe, the byte after each one is
+     * borrowed for as long as it gets printed */
+    message                         = batch->buffer + consumed + sizeof(report);
+    terminator                      = message[report.message_length];
+    message[report.message_length] = '\0';
+    _cspec_record_test(
+      cspec->nodes[id].name,
+      batch->display_tab,
+      report.status,
+      message,
+      id,
+      report.duration
+    );
+    message[report.message_length] = terminator;
+    consumed += sizeof(report) + report.message_length;
+
+    if(report.high_water_mark > cspec->arena.high_water_mark) {
+      cspec->arena.high_water_mark = report.high_water_mark;
+    }
+  }
+}
+
+/**
+ * @brief Writes out the buffered output up to the first batch that is
+ * still running, with the results of the finished ones in between
+ */
+static void _cspec_emit_isolated(void) {
+  size_t written = 0;
+  size_t end;
+  size_t b;
+
+  for(b = 0; b < cspec->number_of_isolated && cspec->isolated[b].done; b++) {
+    _cspec_isolated_batch *batch = &cspec->isolated[b];
+
+    fwrite(cspec->output + written, 1, batch->offset - written, stdout);
+    written          = batch->offset;
+    cspec->buffering = _cspec_false;
+    _cspec_record_batch(batch);
+    cspec->buffering = _cspec_true;
+    free(batch->ids);
+    free(batch->buffer);
+  }
+
+  cspec->number_of_isolated -= b;
+  memmove(
+    cspec->isolated,
+    cspec->isolated + b,
+    cspec->number_of_isolated * sizeof(_cspec_isolated_batch)
+  );
+  end = cspec->number_of_isolated > 0 ? cspec->isolated[0].offset
+                                      : cspec->output_size;
+  if(end > written) {
+    fwrite(cspec->output + written, 1, end - written, stdout);
+  }
+  if(end > 0) {
+    cspec->output_size -= end;
+    memmove(cspec->output, cspec->output + end, cspec->output_size);
+    for(b = 0; b < cspec->number_of_isolated; b++) {
+      cspec->isolated[b].offset -= end;
+    }
+  }
+}
+
+/**
+ * @brief Collects the reports of forked batches until at most `limit` of
+ * them are still running, then prints the results that are in order
+ * @param limit -> The number of children that may keep running
+ */
+static void _cspec_wait_for_tests(size_t limit) {
+  struct pollfd *fds;
+  int next_deadline;
+  size_t b;
+
+  if(cspec->isolate == 0 || cspec->number_of_isolated == 0) {
+    return;
+  }
+
+  fds = (struct pollfd *)malloc(
+    cspec->number_of_isolated * sizeof(struct pollfd)
+  );
+  do {
+    for(b = 0; b < cspec->number_of_isolated; b++) {
+      fds[b].fd      = cspec->isolated[b].done ? -1 : cspec->isolated[b].fd;
+      fds[b].events  = POLLIN;
+      fds[b].revents = 0;
+    }
+    next_deadline = _cspec_kill_late_batches();
+    if(poll(
+         fds,
+         (nfds_t)cspec->number_of_isolated,
+         cspec->running_isolated > limit ? next_deadline : 0
+       ) < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    for(b = 0; b < cspec->number_of_isolated; b++) {
+      _cspec_isolated_batch *batch = &cspec->isolated[b];
+      ssize_t bytes;
+
+      if(fds[b].fd < 0 || fds[b].revents == 0) {
+        continue;
+      }
+      if(batch->capacity - batch->size < 4096) {
+        batch->capacity = 2 * batch->capacity + 4096;
+        batch->buffer   = (char *)realloc(batch->buffer, batch->capacity);
+      }
+      /* One byte stays free for terminating the last message */
+      bytes = read(
+        batch->fd,
+        batch->buffer + batch->size,
+        batch->capacity - batch->size - 1
+      );
+      if(bytes > 0) {
+        batch->size += (size_t)bytes;
+        /* Every report starts the clock of the next test over */
+        if(batch->limit > 0) {
+          batch->deadline = cspec_timer() + batch->limit * 1000000;
+        }
+      } else if(bytes == 0 || errno != EINTR) {
+        close(batch->fd);
+        while(waitpid(batch->pid, &batch->status, 0) < 0 && errno == EINTR) {
+        }
+        batch->done = _cspec_true;
+        cspec->running_isolated--;
+      }
+    }
+  } while(cspec->running_isolated > limit);
+  free(fds);
+
+  _cspec_emit_isolated();
+}
+
+/**
+ * @brief Adds the current test to the batch of its forked child, forking
+ * that child first when the last batch is full or ended. Children fork
+ * from the parent, so a batch starts from the state its `before` blocks
+ * built once, no matter how many batches follow
+ * @return True when the body of the test runs in this process
+ */
+static cspec_bool _cspec_isolate_test(void) {
+  _cspec_isolated_batch *batch;
+  int fds[2];
+  pid_t pid;
+  size_t b;
+
+  if(cspec->report_fd >= 0) {
+    /* The child runs the following tests of its batch until it is full */
+    if(cspec->batch_size == cspec->isolate_batch) {
+      fflush(stdout);
+      _exit(0);
+    }
+    cspec->batch_size++;
+    return _cspec_true;
+  }
+  if(cspec->isolate == 0) {
+    return _cspec_true;
+  }
+
+  batch = cspec->number_of_isolated > 0
+            ? &cspec->isolated[cspec->number_of_isolated - 1]
+            : NULL;
+  if(batch == NULL || batch->breaks != cspec->batch_breaks ||
+     batch->number_of_tests == cspec->isolate_batch) {
+    _cspec_wait_for_tests(cspec->isolate - 1);
+    /* Output that is still in the stdio buffer would be written twice */
+    fflush(stdout);
+    if(pipe(fds) != 0) {
+      return _cspec_true;
+    }
+    pid = fork();
+    if(pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      return _cspec_true;
+    }
+    if(pid == 0) {
+      close(fds[0]);
+      for(b = 0; b < cspec->number_of_isolated; b++) {
+        if(!cspec->isolated[b].done) {
+          close(cspec->isolated[b].fd);
+        }
+      }
+      cspec->report_fd  = fds[1];
+      cspec->isolate    = 0;
+      cspec->batch_size = 1;
+      return _cspec_true;
+    }
+    close(fds[1]);
+
+    if(cspec->number_of_isolated == cspec->capacity_of_isolated) {
+      cspec->capacity_of_isolated = 2 * cspec->capacity_of_isolated + 8;
+      cspec->isolated             = (_cspec_isolated_batch *)realloc(
+        cspec->isolated,
+        cspec->capacity_of_isolated * sizeof(_cspec_isolated_batch)
+      );
+    }
+    batch                  = &cspec->isolated[cspec->number_of_isolated++];
+    batch->pid             = pid;
+    batch->fd              = fds[0];
+    batch->ids             = (size_t *)malloc(
+      cspec->isolate_batch * sizeof(size_t)
+    );
+    batch->number_of_tests = 0;
+    batch->breaks          = cspec->batch_breaks;
+    batch->display_tab     = cspec->display_tab;
+    batch->offset          = cspec->output_size;
+    batch->done            = _cspec_false;
+    batch->status          = 0;
+    batch->buffer          = NULL;
+    batch->size            = 0;
+    batch->capacity        = 0;
+    batch->limit           = cspec->timeout > 0 ? cspec->timeout
+                                                : cspec->default_timeout;
+    batch->deadline        = 0;
+    batch->timed_out       = _cspec_false;
+    if(batch->limit > 0) {
+      batch->deadline = cspec_timer() + batch->limit * 1000000;
+    }
+    cspec->running_isolated++;
+  }
+
+  batch->ids[batch->number_of_tests++] = cspec->current_test;
+  return _cspec_false;
+}
+#else
+  #define _cspec_isolate_test() _cspec_true
+  #define _cspec_wait_for_tests(limit)
+#endif
+
+/**
+ * @brief Counts and prints the test that just ran, or sends it to the
+ * parent when it ran in a forked child
+ * @param name -> The name of the test
+ * @param duration -> The time the test body took
+ */
+static void _cspec_finish_test(const char *name, size_t duration) {
+#if defined(CSPEC_HAS_FORK)
+  if(cspec->report_fd >= 0) {
+    _cspec_send_test_report(duration);
+    return;
+  }
+#endif
+  _cspec_record_test(
+    name,
+    cspec->display_tab,
+    cspec->status_of_test,
+    cspec->test_result_message,
+    cspec->current_test,
+    duration
+  );
+}
+
+/**
+ * @brief Hands the modules to the forked workers or to the thread pool
+ * when either was asked for and there is more than one module
+ * @return False when the modules still have to run in this thread
+ */
+static cspec_bool _cspec_run_modules_concurrently(
+  _cspec_scheduled_module *modules, size_t number_of_modules
+) {
+#if defined(CSPEC_HAS_FORK)
+  if(cspec->jobs > 1 && number_of_modules > 1 &&
+     _cspec_run_modules_in_parallel(modules, number_of_modules)) {
+    return _cspec_true;
+  }
+#endif
+#if defined(CSPEC_THREAD_POOL)
+  if(cspec->threads > 1 && number_of_modules > 1) {
+    _cspec_run_modules_on_threads(modules, number_of_modules);
+    return _cspec_true;
+  }
+#endif
+  (void)modules;
+  (void)number_of_modules;
+  return _cspec_false;
+}
+
+/**
+ * @brief Lists the modules that hold selected tests, in the order they
+ * will be printed
+ * @return The number of modules in `modules`
+ */
+static size_t _cspec_schedule_modules(_cspec_scheduled_module *modules) {
+  size_t number_of_modules = 0;
+  size_t id;
+
+  for(id = 0; id < cspec->number_of_nodes; id = cspec->nodes[id].end) {
+    if(cspec->nodes[id].kind == CSPEC_NODE_MODULE &&
+       cspec->nodes[id].selected > 0) {
+      modules[number_of_modules].id            = id;
+      modules[number_of_modules].weight        = 0;
+      modules[number_of_modules].done          = _cspec_false;
+      modules[number_of_modules].lost          = 0;
+      modules[number_of_modules].output        = NULL;
+      modules[number_of_modules].output_length = 0;
+      number_of_modules++;
+    }
+  }
+  if(cspec->random_order) {
+    unsigned long long state = cspec->seed;
+    for(id = number_of_modules; id > 1; id--) {
+      size_t other = (size_t)(_cspec_next_random(&state) % id);
+      _cspec_scheduled_module module = modules[id - 1];
+      modules[id - 1]                = modules[other];
+      modules[other]                 = module;
+    }
+  }
+  _cspec_weigh_modules(modules, number_of_modules);
+
+  return number_of_modules;
+}
+
+/**
+ * @brief Set when the suite runs more than once, which keeps a sample of
+ * every test after each run
+ */
+#define _cspec_is_repeating() (cspec->repeat > 1 || cspec->until_failure)
+
+/**
+ * @brief Decides whether the selected tests run once more
+ * @param pass -> The number of runs so far
+ * @param failed -> Set when a test failed in the last run
+ * @param ran -> Set when any test passed or failed in the last run
+ */
+static cspec_bool _cspec_runs_again(
+  size_t pass, cspec_bool failed, cspec_bool ran
+) {
+  if(!ran || _cspec_reached_max_failures()) {
+    return _cspec_false;
+  }
+  if(cspec->until_failure) {
+    return !failed && (cspec->repeat == 1 || pass < cspec->repeat);
+  }
+  return pass < cspec->repeat;
+}
+
+/**
+ * @brief Forgets what the last run measured, so that tests which do not
+ * run again are not sampled twice
+ */
+static void _cspec_clear_results(void) {
+  size_t id;
+
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    cspec->nodes[id].duration = CSPEC_NO_DURATION;
+    cspec->nodes[id].failed   = _cspec_false;
+  }
+}
+
+/**
+ * @brief Keeps the duration and status of every test of the last run
+ */
+static void _cspec_sample_tests(void) {
+  size_t id;
+
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    const _cspec_node *node = &cspec->nodes[id];
+    _cspec_sample *sample;
+
+    if(node->kind != CSPEC_NODE_IT ||
+       (node->duration == CSPEC_NO_DURATION && !node->failed)) {
+      continue;
+    }
+    if(cspec->number_of_samples == cspec->capacity_of_samples) {
+      cspec->capacity_of_samples =
+        cspec->capacity_of_samples ? 2 * cspec->capacity_of_samples : 64;
+      cspec->samples = (_cspec_sample *)realloc(
+        cspec->samples, cspec->capacity_of_samples * sizeof(_cspec_sample)
+      );
+    }
+    sample           = &cspec->samples[cspec->number_of_samples++];
+    sample->id       = id;
+    sample->duration = node->duration;
+    sample->failed   = node->failed;
+  }
+}
+
+/**
+ * @brief Orders samples by test, fastest run first
+ */
+static int _cspec_compare_samples(const void *a, const void *b) {
+  const _cspec_sample *left  = (const _cspec_sample *)a;
+  const _cspec_sample *right = (const _cspec_sample *)b;
+
+  if(left->id != right->id) {
+    return left->id < right->id ? -1 : 1;
+  }
+  return left->duration < right->duration   ? -1
+         : left->duration > right->duration ? 1
+                                            : 0;
+}
+
+/**
+ * @brief Prints how often every test passed over all runs along with its
+ * fastest, median and slowest duration. A test that failed in any run is
+ * kept as failing for CSPEC_JOURNAL
+ * @param passes -> The number of times the suite ran
+ */
+static void _cspec_report_samples(size_t passes) {
+  size_t first;
+  size_t last;
+
+  if(cspec->number_of_samples > 0) {
+    qsort(
+      cspec->samples,
+      cspec->number_of_samples,
+      sizeof(_cspec_sample),
+      _cspec_compare_samples
+    );
+  }
+  printf(
+    "\n%s◆ Ran %zu times: pass rate, min, median and max duration%s\n",
+    cspec->GRAY,
+    passes,
+    cspec->RESET
+  );
+
+  for(first = 0; first < cspec->number_of_samples; first = last) {
+    size_t id       = cspec->samples[first].id;
+    size_t runs     = 0;
+    size_t timed    = 0;
+    size_t failures = 0;
+    double rate;
+
+    for(last = first; last < cspec->number_of_samples &&
+                      cspec->samples[last].id == id;
+        last++) {
+      runs++;
+      timed += cspec->samples[last].duration != CSPEC_NO_DURATION;
+      failures += cspec->samples[last].failed;
+    }
+    rate = 100.0 * (double)(runs - failures) / (double)runs;
+
+    cspec->nodes[id].failed = failures > 0;
+    printf(
+      "%s%6.1f%%%s",
+      failures == 0      ? cspec->GREEN
+      : failures == runs ? cspec->RED
+                         : cspec->YELLOW,
+      rate,
+      cspec->RESET
+    );
+    if(timed > 0) {
+      printf(
+        " %10.5f ms %10.5f ms %10.5f ms  ",
+        cspec->samples[first].duration / 1000000.0,
+        cspec->samples[first + (timed - 1) / 2].duration / 1000000.0,
+        cspec->samples[first + timed - 1].duration / 1000000.0
+      );
+    } else {
+      printf(" %13s %13s %13s  ", "-", "-", "-");
+    }
+    _cspec_write_path(stdout, id);
+    putchar('\n');
+  }
+
+  free(cspec->samples);
+  cspec->samples             = NULL;
+  cspec->number_of_samples   = 0;
+  cspec->capacity_of_samples = 0;
+}
+
+#if defined(CSPEC_HAS_SIGNALS)
+/**
+ * @brief Runs every test in a forked child once a limit or crash catching
+ * is on, so that a test that hangs gets killed and one that crashes takes
+ * only its child down. Threads that were asked for become children
+ */
+static void _cspec_isolate_guarded_tests(void) {
+  if(!cspec->uses_timeouts && !cspec->catch_crashes) {
+    return;
+  }
+  if(cspec->isolate == 0) {
+    cspec->isolate = cspec->threads;
+  }
+  cspec->threads = 1;
+}
+#endif
+
+/**
+ * @brief Executes the selected tests by calling every module that holds
+ * at least one of them. Workers take the longest modules first, but the
+ * output always comes in the order they were discovered, or in a shuffled
+ * one with CSPEC_ORDER=random, which also shuffles the tests of each
+ * module. With CSPEC_REPEAT or CSPEC_UNTIL_FAILURE the same tests run again
+ * in this process
+ */
+static void _cspec_run_tree(void) {
+  _cspec_scheduled_module *modules = (_cspec_scheduled_module *)malloc(
+    (cspec->number_of_nodes + 1) * sizeof(_cspec_scheduled_module)
+  );
+  size_t number_of_modules;
+  size_t pass = 0;
+  size_t failures;
+  size_t results;
+  size_t id;
+
+  _cspec_read_history();
+  _cspec_read_journal();
+  _cspec_select_tests();
+#if defined(CSPEC_HAS_SIGNALS)
+  _cspec_isolate_guarded_tests();
+#endif
+
+  do {
+    pass++;
+    failures = cspec->number_of_failing_tests;
+    results  = cspec->number_of_passing_tests + failures;
+    if(_cspec_is_repeating()) {
+      printf("\n%s◆ Run %zu%s\n", cspec->GRAY, pass, cspec->RESET);
+      _cspec_clear_results();
+    }
+    number_of_modules = _cspec_schedule_modules(modules);
+
+    /* Forked tests print once they report, in between the buffered blocks */
+    cspec->buffering = cspec->isolate > 0;
+    if(!_cspec_run_modules_concurrently(modules, number_of_modules)) {
+      for(id = 0; id < number_of_modules; id++) {
+        _cspec_run_module(modules[id].id);
+      }
+    }
+    cspec->buffering = _cspec_false;
+
+    if(_cspec_is_repeating()) {
+      _cspec_sample_tests();
+    }
+  } while(_cspec_runs_again(
+    pass,
+    cspec->number_of_failing_tests > failures,
+    cspec->number_of_passing_tests + cspec->number_of_failing_tests > results
+  ));
+
+  if(_cspec_is_repeating()) {
+    _cspec_report_samples(pass);
+  }
+  _cspec_write_history();
+  _cspec_write_journal();
+  free(modules);
+}
+
+/**
+ * @brief Prints every discovered node with its id, file and line, along
+ * with the tags it adds to the ones of its parent
+ */
+static void _cspec_list_tests(void) {
+  size_t id;
+  size_t number_of_tests = 0;
+
+  for(id = 0; id < cspec->number_of_nodes; id++) {
+    const _cspec_node *node = &cspec->nodes[id];
+    const char *color       = cspec->RESET;
+    unsigned long long tags = node->tags;
+    size_t tag;
+
+    if(node->parent != CSPEC_NO_NODE) {
+      tags &= ~cspec->nodes[node->parent].tags;
+    }
+
+    if(node->skipped) {
+      color = cspec->GRAY;
+    } else if(node->kind == CSPEC_NODE_MODULE) {
+      color = cspec->YELLOW;
+    } else if(node->kind == CSPEC_NODE_DESCRIBE) {
+      color = cspec->PURPLE;
+    }
+    if(node->kind == CSPEC_NODE_IT) {
+      number_of_tests++;
+    }
+
+    printf(
+      "%s%s%zu %s%s%s %s(%s:%zu)",
+      node->depth == 0 ? "\n" : "",
+      cspec->indentation
+        [node->depth < CSPEC_MAX_DEPTH ? node->depth : CSPEC_MAX_DEPTH],
+      id,
+      color,
+      node->name,
+      cspec->RESET,
+      cspec->GRAY,
+      node->file,
+      node->line
+    );
+    for(tag = 0; tag < cspec->number_of_tags; tag++) {
+      if(tags & (1ULL << tag)) {
+        printf(
+          " :%.*s", (int)cspec->tag_lengths[tag], cspec->tag_names[tag]
+        );
+      }
+    }
+    printf("%s\n", cspec->RESET);
+  }
+
+  printf("\n%s● %zu tests%s\n", cspec->YELLOW, number_of_tests, cspec->RESET);
+}
+
+/**
+ * @brief A runner option as it is given on the command line
+ * @param flag -> The name after `--`
+ * @param variable -> The environment variable it stands for
+ * @param takes_value -> Set when the flag is written as `--flag=value`,
+ * the others are switches that are turned on by naming them
+ * @param help -> What the option does
+ */
+typedef struct {
+  const char *flag;
+  const char *variable;
+  cspec_bool takes_value;
+  const char *help;
+} _cspec_option;
+
+static const _cspec_option _cspec_options[] = {
+  {"list", "CSPEC_LIST", _cspec_false, "print the tests instead of running"},
+  {"id", "CSPEC_ID", _cspec_true, "run the tests under the block with this id"},
+  {"filter", "CSPEC_FILTER", _cspec_true, "run the tests whose path matches"},
+  {"tags", "CSPEC_TAGS", _cspec_true, "run the tests whose tags match"},
+  {"jobs", "CSPEC_JOBS", _cspec_true, "spread modules over n workers"},
+  {"threads", "CSPEC_THREADS", _cspec_true, "spread modules over n threads"},
+  {"history", "CSPEC_HISTORY", _cspec_true, "keep test durations in a file"},
+  {"journal", "CSPEC_JOURNAL", _cspec_true, "keep failing tests in a file"},
+  {"rerun-failed", "CSPEC_RERUN_FAILED", _cspec_false, "run the journal"},
+  {"shard-index", "CSPEC_SHARD_INDEX", _cspec_true, "run this shard"},
+  {"shard-count", "CSPEC_SHARD_COUNT", _cspec_true, "split into n shards"},
+  {"shard-balance", "CSPEC_SHARD_BALANCE", _cspec_false, "split by history"},
+  {"order", "CSPEC_ORDER", _cspec_true, "`random` shuffles the tests"},
+  {"seed", "CSPEC_SEED", _cspec_true, "replay a shuffled order"},
+  {"repeat", "CSPEC_REPEAT", _cspec_true, "run the tests n times"},
+  {"until-failure",
+   "CSPEC_UNTIL_FAILURE",
+   _cspec_false,
+   "repeat until a test fails"},
+  {"fail-fast", "CSPEC_FAIL_FAST", _cspec_false, "stop at the first failure"},
+  {"max-failures", "CSPEC_MAX_FAILURES", _cspec_true, "stop after n failures"},
+#if defined(CSPEC_HAS_SIGNALS)
+  {"timeout", "CSPEC_TIMEOUT", _cspec_true, "fail tests that take over n ms"},
+  {"catch-crashes", "CSPEC_CATCH_CRASHES", _cspec_false, "fail crashing tests"},
+#endif
+  {"isolate", "CSPEC_ISOLATE", _cspec_true, "fork each test, n at once"},
+  {"isolate-batch", "CSPEC_ISOLATE_BATCH", _cspec_true, "tests per child"},
+};
+
+#define CSPEC_NUMBER_OF_OPTIONS \
+  (sizeof(_cspec_options) / sizeof(_cspec_options[0]))
+
+/**
+ * @brief The values given on the command line, by their index in
+ * `_cspec_options`. They are set once in main before any thread starts
+ */
+static const char *_cspec_arguments[CSPEC_NUMBER_OF_OPTIONS];
+
+/**
+ * @brief Looks up a runner option on the command line, then in the
+ * environment
+ * @param variable -> The CSPEC_* name of the option
+ */
+static const char *_cspec_get_option(const char *variable) {
+  size_t option;
+
+  for(option = 0; option < CSPEC_NUMBER_OF_OPTIONS; option++) {
+    if(_cspec_arguments[option] != NULL &&
+       !strcmp(_cspec_options[option].variable, variable)) {
+      return _cspec_arguments[option];
+    }
+  }
+  return getenv(variable);
+}
+
+/**
+ * @brief Reads a runner option that has to be a whole number. Anything else
+ * exits with CSPEC_EXIT_USAGE instead of being read as 0, which some
+ * options take as one worker for every core
+ * @param variable -> The CSPEC_* name of the option
+ * @param value -> What it is set to, or NULL
+ * @param number -> Gets the value when the option is set
+ * @return Whether the option is set
+ */
+static cspec_bool _cspec_read_number(
+  const char *variable, const char *value, unsigned long long *number
+) {
+  char *end;
+
+  if(value == NULL || *value == '\0') {
+    return _cspec_false;
+  }
+  errno   = 0;
+  *number = strtoull(value, &end, 10);
+  if(*value < '0' || *value > '9' || *end != '\0' || errno == ERANGE) {
+    printf(
+      "\n\033[1;31m%s has to be a whole number, not `%s`\033[0m\n",
+      variable,
+      value
+    );
+    exit(CSPEC_EXIT_USAGE);
+  }
+  return _cspec_true;
+}
+
+/**
+ * @brief Reads the runner options that can be given through the environment
+ * or the command line
+ */
+static void _cspec_read_environment(void) {
+  const char *list    = _cspec_get_option("CSPEC_LIST");
+  const char *id      = _cspec_get_option("CSPEC_ID");
+  const char *filter  = _cspec_get_option("CSPEC_FILTER");
+  const char *tags    = _cspec_get_option("CSPEC_TAGS");
+  const char *jobs    = _cspec_get_option("CSPEC_JOBS");
+  const char *threads = _cspec_get_option("CSPEC_THREADS");
+  const char *history = _cspec_get_option("CSPEC_HISTORY");
+  const char *journal = _cspec_get_option("CSPEC_JOURNAL");
+  const char *rerun   = _cspec_get_option("CSPEC_RERUN_FAILED");
+  const char *index   = _cspec_get_option("CSPEC_SHARD_INDEX");
+  const char *count   = _cspec_get_option("CSPEC_SHARD_COUNT");
+  const char *balance = _cspec_get_option("CSPEC_SHARD_BALANCE");
+  const char *order   = _cspec_get_option("CSPEC_ORDER");
+  const char *seed    = _cspec_get_option("CSPEC_SEED");
+  const char *repeat  = _cspec_get_option("CSPEC_REPEAT");
+  const char *until   = _cspec_get_option("CSPEC_UNTIL_FAILURE");
+  const char *fast    = _cspec_get_option("CSPEC_FAIL_FAST");
+  const char *maximum = _cspec_get_option("CSPEC_MAX_FAILURES");
+  const char *timeout = _cspec_get_option("CSPEC_TIMEOUT");
+  const char *crashes = _cspec_get_option("CSPEC_CATCH_CRASHES");
+  const char *isolate = _cspec_get_option("CSPEC_ISOLATE");
+  const char *batch   = _cspec_get_option("CSPEC_ISOLATE_BATCH");
+  unsigned long long number;
+
+  cspec->list_tests   = list != NULL && *list != '\0' && strcmp(list, "0");
+  cspec->history      = history != NULL && *history != '\0' ? history : NULL;
+  cspec->journal      = journal != NULL && *journal != '\0' ? journal : NULL;
+  cspec->rerun_failed = rerun != NULL && *rerun != '\0' && strcmp(rerun, "0");
+  cspec->filter       = filter != NULL && *filter != '\0' ? filter : NULL;
+  cspec->selected_id  = CSPEC_NO_NODE;
+  if(_cspec_read_number("CSPEC_ID", id, &number)) {
+    cspec->selected_id = (size_t)number;
+  }
+
+  cspec->tag_expression = tags != NULL && *tags != '\0' ? tags : NULL;
+  cspec->number_of_tags = 0;
+  cspec->next_tags      = 0;
+
+  cspec->shard_index    = 0;
+  cspec->shard_count    = 1;
+  cspec->balance_shards = balance != NULL && *balance != '\0' &&
+                          strcmp(balance, "0");
+  if(_cspec_read_number("CSPEC_SHARD_INDEX", index, &number)) {
+    cspec->shard_index = (size_t)number;
+  }
+  if(_cspec_read_number("CSPEC_SHARD_COUNT", count, &number)) {
+    cspec->shard_count = (size_t)number;
+  }
+  /* Running the whole suite instead would let every machine of a split
+   * run every test without anyone noticing */
+  if(cspec->shard_count == 0 || cspec->shard_index >= cspec->shard_count) {
+    printf(
+      "\n\033[1;31mCSPEC_SHARD_INDEX has to be less than "
+      "CSPEC_SHARD_COUNT\033[0m\n"
+    );
+    exit(CSPEC_EXIT_USAGE);
+  }
+
+  /* A seed on its own asks for the order it was printed with */
+  cspec->random_order = order != NULL && !strcmp(order, "random");
+  cspec->seed         = (unsigned long long)(cspec_timer() % 1000000);
+  if(_cspec_read_number("CSPEC_SEED", seed, &number)) {
+    cspec->random_order = _cspec_true;
+    cspec->seed         = number;
+  }
+
+  cspec->repeat        = 1;
+  cspec->until_failure = until != NULL && *until != '\0' && strcmp(until, "0");
+  if(_cspec_read_number("CSPEC_REPEAT", repeat, &number) && number > 0) {
+    cspec->repeat = (size_t)number;
+  }
+  cspec->samples             = NULL;
+  cspec->number_of_samples   = 0;
+  cspec->capacity_of_samples = 0;
+
+  cspec->max_failures = 0;
+  if(_cspec_read_number("CSPEC_MAX_FAILURES", maximum, &number)) {
+    cspec->max_failures = (size_t)number;
+  }
+  if(fast != NULL && *fast != '\0' && strcmp(fast, "0")) {
+    cspec->max_failures = 1;
+  }
+
+  cspec->default_timeout = 0;
+  cspec->catch_crashes   = _cspec_false;
+#if defined(CSPEC_HAS_SIGNALS)
+  if(_cspec_read_number("CSPEC_TIMEOUT", timeout, &number)) {
+    cspec->default_timeout = (size_t)number;
+  }
+  cspec->catch_crashes = crashes != NULL && *crashes != '\0' &&
+                         strcmp(crashes, "0");
+#else
+  /* Timeouts and crashes can only be caught with POSIX signal handling */
+  if((timeout != NULL && *timeout != '\0' && strcmp(timeout, "0")) ||
+     (crashes != NULL && *crashes != '\0' && strcmp(crashes, "0"))) {
+    printf(
+      "\n\033[1;31mCSPEC_TIMEOUT and CSPEC_CATCH_CRASHES need POSIX "
+      "signals, running without them\033[0m\n"
+    );
+  }
+#endif
+  cspec->uses_timeouts = cspec->default_timeout > 0;
+
+  cspec->jobs = 1;
+  if(_cspec_read_number("CSPEC_JOBS", jobs, &number)) {
+    cspec->jobs = (size_t)number;
+  }
+#if defined(CSPEC_HAS_FORK)
+  if(cspec->jobs == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    cspec->jobs = online > 0 ? (size_t)online : 1;
+  }
+#else
+  /* Without fork every module runs in this process */
+  cspec->jobs = 1;
+#endif
+
+  cspec->threads = 1;
+  if(_cspec_read_number("CSPEC_THREADS", threads, &number)) {
+    cspec->threads = (size_t)number;
+  }
+#if defined(CSPEC_THREAD_POOL) && defined(CSPEC_HAS_FORK)
+  if(cspec->threads == 0) {
+    long online    = sysconf(_SC_NPROCESSORS_ONLN);
+    cspec->threads = online > 0 ? (size_t)online : 1;
+  }
+#elif !defined(CSPEC_THREAD_POOL)
+  /* The pool is only compiled in when CSPEC_THREAD_POOL is defined */
+  cspec->threads = 1;
+#endif
+  if(cspec->threads == 0) {
+    cspec->threads = 1;
+  }
+
+  cspec->isolate       = 0;
+  cspec->isolate_batch = 1;
+  if(_cspec_read_number("CSPEC_ISOLATE", isolate, &number)) {
+    cspec->isolate = (size_t)number;
+  }
+  if(_cspec_read_number("CSPEC_ISOLATE_BATCH", batch, &number) && number > 0) {
+    cspec->isolate_batch = (size_t)number;
+  }
+#if defined(CSPEC_HAS_FORK)
+  if(isolate != NULL && *isolate != '\0' && cspec->isolate == 0) {
+    long online    = sysconf(_SC_NPROCESSORS_ONLN);
+    cspec->isolate = online > 0 ? (size_t)online : 1;
+  }
+  /* Forking next to other threads would copy the locks they hold */
+  if(cspec->isolate > 0) {
+    cspec->threads = 1;
+  }
+  cspec->isolated             = NULL;
+  cspec->number_of_isolated   = 0;
+  cspec->capacity_of_isolated = 0;
+  cspec->running_isolated     = 0;
+  cspec->batch_breaks         = 0;
+  cspec->report_fd            = -1;
+  cspec->batch_size           = 0;
+#else
+  /* Tests can only be isolated in forked children */
+  cspec->isolate = 0;
+#endif
+}
+
+/**
+ * @brief Prints the options the runner takes on the command line
+ * @param program -> The name the runner was started with
+ */
+static inline void _cspec_print_usage(const char *program) {
+  size_t option;
+
+  printf("\nUsage: %s [options]\n\n", program);
+  printf(
+    "  --%-24s %s\n", "type=passing,failing", "the results to print, all"
+  );
+  printf("  --%-24s %s\n", "output=file", "write the report to a file");
+  printf("  --%-24s %s\n", "help", "print this message");
+  for(option = 0; option < CSPEC_NUMBER_OF_OPTIONS; option++) {
+    char flag[32];
+
+    snprintf(
+      flag,
+      sizeof(flag),
+      "%s%s",
+      _cspec_options[option].flag,
+      _cspec_options[option].takes_value ? "=value" : ""
+    );
+    printf("  --%-24s %s\n", flag, _cspec_options[option].help);
+  }
+  printf("\nEvery option can also be set as its CSPEC_* variable.\n");
+}
+
+/**
+ * @brief Reads the runner options of cspec_run_suite_argv. Unknown or
+ * malformed arguments print the usage and exit with CSPEC_EXIT_USAGE
+ * @return The display filter of `--type`, which defaults to all
+ */
+static inline unsigned int _cspec_parse_arguments(int argc, char **argv) {
+  unsigned int display_filter = CSPEC_DISPLAY_ALL;
+  int position;
+
+  for(position = 1; position < argc; position++) {
+    const char *argument = argv[position];
+    const char *value;
+    size_t length;
+    size_t option;
+
+    if(strncmp(argument, "--", 2) != 0) {
+      printf("\n\033[1;31mUnknown argument `%s`\033[0m\n", argument);
+      _cspec_print_usage(argv[0]);
+      exit(CSPEC_EXIT_USAGE);
+    }
+    argument += 2;
+    value  = strchr(argument, '=');
+    length = value != NULL ? (size_t)(value - argument) : strlen(argument);
+    if(value != NULL) {
+      value++;
+    }
+
+    if(length == 4 && !strncmp(argument, "help", 4)) {
+      _cspec_print_usage(argv[0]);
+      exit(EXIT_SUCCESS);
+    }
+    if(length == 4 && !strncmp(argument, "type", 4) && value != NULL) {
+      display_filter = _cspec_parse_display_filter(value);
+      if(display_filter == 0) {
+        printf(
+          "\n\033[1;31mInput a type of test to log "
+          "passing|failing|skipped|all\033[0m\n\n"
+        );
+        exit(CSPEC_EXIT_USAGE);
+      }
+      continue;
+    }
+    if(length == 6 && !strncmp(argument, "output", 6) && value != NULL) {
+      if(freopen(value, "w", stdout) == NULL) {
+        fprintf(stderr, "Could not open `%s` for the report\n", value);
+        exit(CSPEC_EXIT_USAGE);
+      }
+      continue;
+    }
+
+    for(option = 0; option < CSPEC_NUMBER_OF_OPTIONS; option++) {
+      if(strlen(_cspec_options[option].flag) == length &&
+         !strncmp(_cspec_options[option].flag, argument, length) &&
+         _cspec_options[option].takes_value == (value != NULL)) {
+        _cspec_arguments[option] = value != NULL ? value : "1";
+        break;
+      }
+    }
+    if(option == CSPEC_NUMBER_OF_OPTIONS) {
+      printf("\n\033[1;31mUnknown argument `--%s`\033[0m\n", argument);
+      _cspec_print_usage(argv[0]);
+      exit(CSPEC_EXIT_USAGE);
+    }
+  }
+
+  return display_filter;
+}
+
+#define is    ==
+#define isnot !=
+
+#define equals ,
+#define to
+#define with
+#define array_size ,
+#define within     ,
+
+/**
+ * @brief Report the number of tests and time taken while testing
+ */
+#define _cspec_report_time_taken_for_tests()                        \
+  do {                                                              \
+    printf(                                                         \
+      "\n%s● %zu tests\n%s✓ %zu passing\n%s✗ %zu failing\n%s- %zu " \
+      "skipped%s\n",                                                \
+      cspec->YELLOW,                                                \
+      cspec->number_of_tests,                                       \
+      cspec->GREEN,                                                 \
+      cspec->number_of_passing_tests,                               \
+      cspec->RED,                                                   \
+      cspec->number_of_failing_tests,                               \
+      cspec->GRAY,                                                  \
+      cspec->number_of_skipped_tests,                               \
+      cspec->RESET                                                  \
+    );                                                              \
+    if(_cspec_reached_max_failures()) {                             \
+      printf(                                                       \
+        "%s■ Stopped at the limit of %zu failing tests%s\n",       \
+        cspec->RED,                                                 \
+        cspec->max_failures,                                        \
+        cspec->RESET                                                \
+      );                                                            \
+    }                                                               \
+                                                                    \
+    /* Print in seconds if the time is more than 100ms */           \
+    if(cspec->total_time_taken_for_tests > 100000000) {             \
+      printf(                                                       \
+        "%s★ Finished in %.5f seconds%s\n",                         \
+        cspec->CYAN,                                                \
+        cspec->total_time_taken_for_tests / 1000000000.0,           \
+        cspec->RESET                                                \
+      );                                                            \
+    } /* Else print in miliseconds */                               \
+    else {                                                          \
+      printf(                                                       \
+        "%s★ Finished in %.5f ms%s\n",                              \
+        cspec->CYAN,                                                \
+        cspec->total_time_taken_for_tests / 1000000.0,              \
+        cspec->RESET                                                \
+      );                                                            \
+    }                                                               \
+    printf(                                                         \
+      "%s◆ Arena high-water mark %zu bytes in %zu mallocs%s\n",     \
+      cspec->GRAY,                                                  \
+      cspec->arena.high_water_mark,                                 \
+      cspec->arena.number_of_mallocs,                               \
+      cspec->RESET                                                  \
+    );                                                              \
+    if(cspec->random_order) {                                       \
+      printf(                                                       \
+        "%s◆ Randomized with seed %llu%s\n",                        \
+        cspec->GRAY,                                                \
+        cspec->seed,                                                \
+        cspec->RESET                                                \
+      );                                                            \
+    }                                                               \
+  } while(0)
+
+/**
+ * @brief Allocates memory for vectors to save test results in
+ */
+#define _cspec_setup_test_data(filter)                                     \
+  do {                                                                     \
     printf("\033[38;5;95m/######## ########/\n");                          \
     printf(                                                                \
       "\033[38;5;95m/##### "                                               \
@@ -631,12 +4425,36 @@ static _cspec_data_struct *cspec;
     cspec->current_actual   = NULL;                                        \
     cspec->current_expected = NULL;                                        \
     cspec->position_in_file = NULL;                                        \
-    cspec->type_of_tests    = (type);                                      \
+    cspec->display_filter   = (filter);                                    \
                                                                            \
     cspec->before_func = NULL;                                             \
     cspec->after_func  = NULL;                                             \
                                                                            \
-    cspec->display_tab = NULL;                                             \
+    cspec->in_skipped_module = _cspec_false;                               \
+    cspec->discovering       = _cspec_false;                               \
+    cspec->nodes             = NULL;                                       \
+    cspec->number_of_nodes   = 0;                                          \
+    cspec->capacity_of_nodes = 0;                                          \
+    cspec->parent_node       = CSPEC_NO_NODE;                              \
+    cspec->next_node         = 0;                                          \
+    cspec->current_test      = CSPEC_NO_NODE;                              \
+    cspec->walk_target       = CSPEC_NO_NODE;                              \
+    cspec->previous_target   = CSPEC_NO_NODE;                              \
+    cspec->buffering         = _cspec_false;                               \
+    cspec->output            = NULL;                                       \
+    cspec->output_size       = 0;                                          \
+    cspec->output_capacity   = 0;                                          \
+    cspec->timeout           = 0;                                          \
+    _cspec_read_environment();                                             \
+                                                                           \
+    memset(cspec->indentation_spaces, ' ', 4 * CSPEC_MAX_DEPTH);           \
+    cspec->indentation_spaces[4 * CSPEC_MAX_DEPTH] = '\0';                 \
+    for(size_t depth = 0; depth <= CSPEC_MAX_DEPTH; depth++) {             \
+      cspec->indentation[depth] =                                          \
+        cspec->indentation_spaces + 4 * (CSPEC_MAX_DEPTH - depth);         \
+    }                                                                      \
+    _cspec_set_depth(0);                                                   \
+    _cspec_arena_initialize(&cspec->arena);                                \
                                                                            \
     cspec->GREEN       = "\033[38;5;78m";                                  \
     cspec->RED         = "\033[38;5;203m";                                 \
@@ -653,26 +4471,29 @@ static _cspec_data_struct *cspec;
 /** Assertions */
 
 
+/**
+ * @brief Empties the operands of the last assertion but keeps their blocks
+ * for the next one. The failure message is bumped on top of them, so it
+ * keeps growing in place instead of being copied past every new operand
+ */
 #define _cspec_clear_assertion_data()              \
   do {                                             \
     cspec->current_file = __FILE__;                \
     cspec->current_line = __LINE__;                \
     _cspec_string_delete(cspec->position_in_file); \
-    _cspec_string_delete(cspec->current_actual);   \
     _cspec_string_delete(cspec->current_expected); \
-    _cspec_string_free(cspec->current_actual);     \
-    _cspec_string_free(cspec->current_expected);   \
+    _cspec_string_delete(cspec->current_actual);   \
   } while(0)
 
-#define _cspec_write_position_in_file()          \
-  do {                                           \
-    _cspec_string_free(cspec->position_in_file); \
-    _cspec_string_addf(                          \
-      cspec->position_in_file,                   \
-      "%s:%zu:",                                 \
-      cspec->current_file,                       \
-      cspec->current_line                        \
-    );                                           \
+#define _cspec_write_position_in_file()            \
+  do {                                             \
+    _cspec_string_delete(cspec->position_in_file); \
+    _cspec_string_addf(                            \
+      cspec->position_in_file,                     \
+      "%s:%zu:",                                   \
+      cspec->current_file,                         \
+      cspec->current_line                          \
+    );                                             \
   } while(0)
 
 #define _cspec_write_assert()                                      \
@@ -712,64 +4533,207 @@ static _cspec_data_struct *cspec;
     );                                                                 \
   } while(0)
 
-#define _cspec_assert_that(                                          \
-  actual, expected, format, comparison, output_function              \
-)                                                                    \
-  do {                                                               \
-    _cspec_string_addf(cspec->current_actual, format, (actual));     \
-    _cspec_string_addf(cspec->current_expected, format, (expected)); \
-    if(comparison(actual, expected)) {                               \
-      output_function();                                             \
-    }                                                                \
+/**
+ * @brief Compares first and only formats the operands on failure, so
+ * a passing assertion costs a single comparison and a branch
+ */
+#define _cspec_assert_that(                                            \
+  actual, expected, format, comparison, output_function                \
+)                                                                      \
+  do {                                                                 \
+    if(comparison(actual, expected)) {                                 \
+      _cspec_string_addf(cspec->current_actual, format, (actual));     \
+      _cspec_string_addf(cspec->current_expected, format, (expected)); \
+      output_function();                                               \
+    }                                                                  \
+  } while(0)
+
+/**
+ * @brief The number of elements rendered on each side of the first mismatch
+ */
+#ifndef CSPEC_ARRAY_WINDOW
+  #define CSPEC_ARRAY_WINDOW 3
+#endif
+
+/**
+ * @brief Renders a bounded window of both arrays around `index`, so failure
+ * messages stay the same size no matter how long the arrays are
+ */
+#define _cspec_assert_array_body(                                          \
+  actual, expected, len_of_array, index, _format                           \
+)                                                                          \
+  do {                                                                     \
+    size_t window_start = 0;                                               \
+    size_t window_end   = (len_of_array);                                  \
+    const char *opening = "[";                                             \
+    const char *closing = "]";                                             \
+                                                                           \
+    /* Keep the window the same width when the index is near an edge */    \
+    if((index) > CSPEC_ARRAY_WINDOW) {                                     \
+      window_start = (index) - CSPEC_ARRAY_WINDOW;                         \
+    }                                                                      \
+    if(window_start + 2 * CSPEC_ARRAY_WINDOW + 1 < window_end) {           \
+      window_end = window_start + 2 * CSPEC_ARRAY_WINDOW + 1;              \
+    } else if(window_end > 2 * CSPEC_ARRAY_WINDOW + 1) {                   \
+      window_start = window_end - (2 * CSPEC_ARRAY_WINDOW + 1);            \
+    } else {                                                               \
+      window_start = 0;                                                    \
+    }                                                                      \
+    if(window_start > 0) {                                                 \
+      opening = "[..., ";                                                  \
+    }                                                                      \
+    if(window_end < (len_of_array)) {                                      \
+      closing = ", ...]";                                                  \
+    }                                                                      \
+                                                                           \
+    _cspec_string_add(cspec->current_actual, opening);                     \
+    _cspec_string_add(cspec->current_expected, opening);                   \
+    for(size_t i = window_start; i < window_end; i++) {                    \
+      if(i > window_start) {                                               \
+        _cspec_string_add(cspec->current_actual, ", ");                    \
+        _cspec_string_add(cspec->current_expected, ", ");                  \
+      }                                                                    \
+      _cspec_string_addf(cspec->current_actual, _format, (actual)[i]);     \
+      _cspec_string_addf(cspec->current_expected, _format, (expected)[i]); \
+    }                                                                      \
+    _cspec_string_add(cspec->current_actual, closing);                     \
+    _cspec_string_add(cspec->current_expected, closing);                   \
+  } while(0)
+
+#define _cspec_write_array_summary(len_of_array, mismatches, index)      \
+  do {                                                                   \
+    if((mismatches) > 0) {                                               \
+      _cspec_string_addf(                                                \
+        cspec->test_result_message,                                      \
+        "%s        |> %zu of %zu elements differ, first at index %zu\n", \
+        cspec->display_tab,                                              \
+        (size_t)(mismatches),                                            \
+        (size_t)(len_of_array),                                          \
+        (size_t)(index)                                                  \
+      );                                                                 \
+    } else {                                                             \
+      _cspec_string_addf(                                                \
+        cspec->test_result_message,                                      \
+        "%s        |> all %zu elements are equal\n",                     \
+        cspec->display_tab,                                              \
+        (size_t)(len_of_array)                                           \
+      );                                                                 \
+    }                                                                    \
+  } while(0)
+
+/**
+ * @brief Scans both arrays first, counting mismatches, and only renders
+ * the window around the first diverging index when the assertion fails
+ */
+#define _cspec_assert_that_array(                                           \
+  actual, expected, len_of_array, _format, comparison, output_function      \
+)                                                                           \
+  do {                                                                      \
+    size_t first_mismatch = 0;                                              \
+    size_t mismatches     = 0;                                              \
+    for(size_t i = 0; i < (len_of_array); i++) {                            \
+      if(comparison((actual)[i], (expected)[i])) {                          \
+        if(mismatches == 0) {                                               \
+          first_mismatch = i;                                               \
+        }                                                                   \
+        mismatches++;                                                       \
+      }                                                                     \
+    }                                                                       \
+    if(mismatches > 0) {                                                    \
+      _cspec_assert_array_body(                                             \
+        actual, expected, len_of_array, first_mismatch, _format             \
+      );                                                                    \
+      output_function();                                                    \
+      _cspec_write_array_summary(len_of_array, mismatches, first_mismatch); \
+    }                                                                       \
   } while(0)
 
-#define _cspec_assert_array_body(actual, expected, len_of_array, _format) \
+#define _cspec_nassert_that_array(                                        \
+  actual, expected, len_of_array, _format, comparison, output_function    \
+)                                                                         \
   do {                                                                    \
-    cspec->current_actual   = cspec_string_new("[");                      \
-    cspec->current_expected = cspec_string_new("[");                      \
-                                                                          \
-    char *format = cspec_string_new(_format);                             \
-    _cspec_string_add(format, ", ");                                      \
-    for(size_t i = 0; i < (len_of_array) - 1; i++) {                      \
-      _cspec_string_addf(cspec->current_actual, format, (actual)[i]);     \
-      _cspec_string_addf(cspec->current_expected, format, (expected)[i]); \
+    for(size_t i = 0; i < (len_of_array); i++) {                          \
+      if(comparison((actual)[i], (expected)[i])) {                        \
+        goto __end;                                                       \
+      }                                                                   \
     }                                                                     \
-    _cspec_string_ignore_last(format, 2);                                 \
-    _cspec_string_add(format, "]");                                       \
-    _cspec_string_addf(                                                   \
-      cspec->current_actual, format, (actual)[(len_of_array) - 1]         \
-    );                                                                    \
-    _cspec_string_addf(                                                   \
-      cspec->current_expected, format, (expected)[(len_of_array) - 1]     \
-    );                                                                    \
-    _cspec_string_free(format);                                           \
-  } while(0)
-
-#define _cspec_assert_that_array(                                      \
-  actual, expected, len_of_array, _format, comparison, output_function \
-)                                                                      \
-  do {                                                                 \
-    _cspec_assert_array_body(actual, expected, len_of_array, _format); \
-    for(size_t i = 0; i < (len_of_array); i++) {                       \
-      if(comparison((actual)[i], (expected)[i])) {                     \
-        output_function();                                             \
-        break;                                                         \
-      }                                                                \
-    }                                                                  \
+    _cspec_assert_array_body(actual, expected, len_of_array, 0, _format); \
+    output_function();                                                    \
+    _cspec_write_array_summary(len_of_array, 0, 0);                       \
+  __end:;                                                                 \
   } while(0)
 
-#define _cspec_nassert_that_array(                                     \
-  actual, expected, len_of_array, _format, comparison, output_function \
-)                                                                      \
-  do {                                                                 \
-    _cspec_assert_array_body(actual, expected, len_of_array, _format); \
-    for(size_t i = 0; i < (len_of_array); i++) {                       \
-      if(comparison((actual)[i], (expected)[i])) {                     \
-        goto __end;                                                    \
-      }                                                                \
-    }                                                                  \
-    output_function();                                                 \
-  __end:;                                                              \
+/**
+ * @brief Finds the first element that differs between two arrays of plain
+ * integral values. Whole blocks are skipped with `memcmp`, which libc
+ * vectorizes for the running cpu, and only the diverging block gets
+ * inspected byte by byte
+ * @param actual -> The first array
+ * @param expected -> The second array
+ * @param len -> The number of elements in both arrays
+ * @param element_size -> The size of a single element in bytes
+ * @return The index of the first mismatch, or `len` if the arrays are equal
+ */
+static size_t _cspec_first_mismatch(
+  const void *actual, const void *expected, size_t len, size_t element_size
+) {
+  const unsigned char *a = (const unsigned char *)actual;
+  const unsigned char *b = (const unsigned char *)expected;
+  size_t bytes           = len * element_size;
+  size_t offset          = 0;
+
+  while(offset < bytes) {
+    size_t block = bytes - offset < 4096 ? bytes - offset : 4096;
+    if(memcmp(a + offset, b + offset, block)) {
+      break;
+    }
+    offset += block;
+  }
+  while(offset < bytes && a[offset] == b[offset]) {
+    offset++;
+  }
+
+  return offset / element_size;
+}
+
+/**
+ * @brief Integral elements are equal exactly when their bytes are, so the
+ * passing path is a single bulk `memcmp` over both arrays
+ */
+#define _cspec_assert_that_integral_array(                                  \
+  actual, expected, len_of_array, _format, comparison, output_function      \
+)                                                                           \
+  do {                                                                      \
+    size_t first_mismatch = 0;                                              \
+    size_t mismatches     = 0;                                              \
+    if((len_of_array) > 0 &&                                                \
+       memcmp((actual), (expected), (len_of_array) * sizeof(*(actual)))) {  \
+      first_mismatch = _cspec_first_mismatch(                               \
+        (actual), (expected), (len_of_array), sizeof(*(actual))             \
+      );                                                                    \
+      for(size_t i = first_mismatch; i < (len_of_array); i++) {             \
+        if(comparison((actual)[i], (expected)[i])) {                        \
+          mismatches++;                                                     \
+        }                                                                   \
+      }                                                                     \
+      _cspec_assert_array_body(                                             \
+        actual, expected, len_of_array, first_mismatch, _format             \
+      );                                                                    \
+      output_function();                                                    \
+      _cspec_write_array_summary(len_of_array, mismatches, first_mismatch); \
+    }                                                                       \
+  } while(0)
+
+#define _cspec_nassert_that_integral_array(                                 \
+  actual, expected, len_of_array, _format, comparison, output_function      \
+)                                                                           \
+  do {                                                                      \
+    if((len_of_array) == 0 ||                                               \
+       !memcmp((actual), (expected), (len_of_array) * sizeof(*(actual)))) { \
+      _cspec_assert_array_body(actual, expected, len_of_array, 0, _format); \
+      output_function();                                                    \
+      _cspec_write_array_summary(len_of_array, 0, 0);                       \
+    }                                                                       \
   } while(0)
 
 /**
@@ -877,13 +4841,13 @@ static inline void _nassert_that_char(char actual, char expected) {
 }
 static inline void
 _assert_that_char_array(char *actual, char *expected, size_t len) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual, expected, len, "'%c'", _cspec_char_comparison, _cspec_write_assert
   );
 }
 static inline void
 _nassert_that_char_array(char *actual, char *expected, size_t len) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual, expected, len, "'%c'", _cspec_char_comparison, _cspec_write_nassert
   );
 }
@@ -929,7 +4893,7 @@ _nassert_that_unsigned_char(unsigned char actual, unsigned char expected) {
 static inline void _assert_that_unsigned_char_array(
   unsigned char *actual, unsigned char *expected, size_t len
 ) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual,
     expected,
     len,
@@ -941,7 +4905,7 @@ static inline void _assert_that_unsigned_char_array(
 static inline void _nassert_that_unsigned_char_array(
   unsigned char *actual, unsigned char *expected, size_t len
 ) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual,
     expected,
     len,
@@ -984,13 +4948,13 @@ static inline void _nassert_that_short(short actual, short expected) {
 }
 static inline void
 _assert_that_short_array(short *actual, short *expected, size_t len) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual, expected, len, "%hd", _cspec_short_comparison, _cspec_write_assert
   );
 }
 static inline void
 _nassert_that_short_array(short *actual, short *expected, size_t len) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual, expected, len, "%hd", _cspec_short_comparison, _cspec_write_nassert
   );
 }
@@ -1040,7 +5004,7 @@ _nassert_that_unsigned_short(unsigned short actual, unsigned short expected) {
 static inline void _assert_that_unsigned_short_array(
   unsigned short *actual, unsigned short *expected, size_t len
 ) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual,
     expected,
     len,
@@ -1052,7 +5016,7 @@ static inline void _assert_that_unsigned_short_array(
 static inline void _nassert_that_unsigned_short_array(
   unsigned short *actual, unsigned short *expected, size_t len
 ) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual,
     expected,
     len,
@@ -1095,13 +5059,13 @@ static inline void _nassert_that_int(int actual, int expected) {
 }
 static inline void
 _assert_that_int_array(int *actual, int *expected, size_t len) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual, expected, len, "%d", _cspec_int_comparison, _cspec_write_assert
   );
 }
 static inline void
 _nassert_that_int_array(int *actual, int *expected, size_t len) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual, expected, len, "%d", _cspec_int_comparison, _cspec_write_nassert
   );
 }
@@ -1147,7 +5111,7 @@ _nassert_that_unsigned_int(unsigned int actual, unsigned int expected) {
 static inline void _assert_that_unsigned_int_array(
   unsigned int *actual, unsigned int *expected, size_t len
 ) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual,
     expected,
     len,
@@ -1159,7 +5123,7 @@ static inline void _assert_that_unsigned_int_array(
 static inline void _nassert_that_unsigned_int_array(
   unsigned int *actual, unsigned int *expected, size_t len
 ) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual,
     expected,
     len,
@@ -1202,13 +5166,13 @@ static inline void _nassert_that_long(long actual, long expected) {
 }
 static inline void
 _assert_that_long_array(long *actual, long *expected, size_t len) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual, expected, len, "%ld", _cspec_long_comparison, _cspec_write_assert
   );
 }
 static inline void
 _nassert_that_long_array(long *actual, long *expected, size_t len) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual, expected, len, "%ld", _cspec_long_comparison, _cspec_write_nassert
   );
 }
@@ -1258,7 +5222,7 @@ _nassert_that_unsigned_long(unsigned long actual, unsigned long expected) {
 static inline void _assert_that_unsigned_long_array(
   unsigned long *actual, unsigned long *expected, size_t len
 ) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual,
     expected,
     len,
@@ -1270,7 +5234,7 @@ static inline void _assert_that_unsigned_long_array(
 static inline void _nassert_that_unsigned_long_array(
   unsigned long *actual, unsigned long *expected, size_t len
 ) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual,
     expected,
     len,
@@ -1317,7 +5281,7 @@ _nassert_that_long_long(long long actual, long long expected) {
 static inline void _assert_that_long_long_array(
   long long *actual, long long *expected, size_t len
 ) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual,
     expected,
     len,
@@ -1329,7 +5293,7 @@ static inline void _assert_that_long_long_array(
 static inline void _nassert_that_long_long_array(
   long long *actual, long long *expected, size_t len
 ) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual,
     expected,
     len,
@@ -1386,7 +5350,7 @@ static inline void _nassert_that_unsigned_long_long(
 static inline void _assert_that_unsigned_long_long_array(
   unsigned long long *actual, unsigned long long *expected, size_t len
 ) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual,
     expected,
     len,
@@ -1398,7 +5362,7 @@ static inline void _assert_that_unsigned_long_long_array(
 static inline void _nassert_that_unsigned_long_long_array(
   unsigned long long *actual, unsigned long long *expected, size_t len
 ) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual,
     expected,
     len,
@@ -1441,13 +5405,13 @@ static inline void _nassert_that_size_t(size_t actual, size_t expected) {
 }
 static inline void
 _assert_that_size_t_array(size_t *actual, size_t *expected, size_t len) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual, expected, len, "%zu", _cspec_size_t_comparison, _cspec_write_assert
   );
 }
 static inline void
 _nassert_that_size_t_array(size_t *actual, size_t *expected, size_t len) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual, expected, len, "%zu", _cspec_size_t_comparison, _cspec_write_nassert
   );
 }
@@ -1489,14 +5453,14 @@ _nassert_that_void_ptr(const void *actual, const void *expected) {
 static inline void _assert_that_void_ptr_array(
   const void **actual, const void **expected, size_t len
 ) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual, expected, len, "%p", _cspec_void_ptr_comparison, _cspec_write_assert
   );
 }
 static inline void _nassert_that_void_ptr_array(
   const void **actual, const void **expected, size_t len
 ) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual,
     expected,
     len,
@@ -1543,7 +5507,7 @@ _nassert_that_ptrdiff_t(ptrdiff_t actual, ptrdiff_t expected) {
 static inline void _assert_that_ptrdiff_t_array(
   ptrdiff_t *actual, ptrdiff_t *expected, size_t len
 ) {
-  _cspec_assert_that_array(
+  _cspec_assert_that_integral_array(
     actual,
     expected,
     len,
@@ -1555,7 +5519,7 @@ static inline void _assert_that_ptrdiff_t_array(
 static inline void _nassert_that_ptrdiff_t_array(
   ptrdiff_t *actual, ptrdiff_t *expected, size_t len
 ) {
-  _cspec_nassert_that_array(
+  _cspec_nassert_that_integral_array(
     actual,
     expected,
     len,
@@ -1565,6 +5529,381 @@ static inline void _nassert_that_ptrdiff_t_array(
   );
 }
 
+/**
+ * @brief How far apart two floating point elements are allowed to be
+ * @param CSPEC_TOLERANCE_ABSOLUTE -> |a - e| <= value
+ * @param CSPEC_TOLERANCE_RELATIVE -> |a - e| <= value * max(|a|, |e|)
+ * @param CSPEC_TOLERANCE_ULP -> At most `value` representable numbers apart
+ */
+typedef enum {
+  CSPEC_TOLERANCE_ABSOLUTE,
+  CSPEC_TOLERANCE_RELATIVE,
+  CSPEC_TOLERANCE_ULP
+} cspec_tolerance_mode;
+
+typedef struct {
+  cspec_tolerance_mode mode;
+  double value;
+} cspec_tolerance;
+
+static inline cspec_tolerance cspec_absolute_tolerance(double value) {
+  cspec_tolerance tolerance;
+  tolerance.mode  = CSPEC_TOLERANCE_ABSOLUTE;
+  tolerance.value = value;
+  return tolerance;
+}
+static inline cspec_tolerance cspec_relative_tolerance(double value) {
+  cspec_tolerance tolerance;
+  tolerance.mode  = CSPEC_TOLERANCE_RELATIVE;
+  tolerance.value = value;
+  return tolerance;
+}
+static inline cspec_tolerance cspec_ulp_tolerance(double value) {
+  cspec_tolerance tolerance;
+  tolerance.mode  = CSPEC_TOLERANCE_ULP;
+  tolerance.value = value;
+  return tolerance;
+}
+
+static inline const char *_cspec_tolerance_name(cspec_tolerance tolerance) {
+  switch(tolerance.mode) {
+    case CSPEC_TOLERANCE_ABSOLUTE:
+      return "absolute";
+    case CSPEC_TOLERANCE_RELATIVE:
+      return "relative";
+    default:
+      return "ulp";
+  }
+}
+
+/**
+ * @param mismatches -> The number of elements outside of the tolerance
+ * @param first_mismatch -> The index of the first of them
+ * @param max_error -> The largest error seen, in the unit of the tolerance
+ */
+typedef struct {
+  size_t mismatches;
+  size_t first_mismatch;
+  double max_error;
+} _cspec_tolerance_result;
+
+static inline void _cspec_tolerance_account(
+  _cspec_tolerance_result *result, size_t index, double error, int bad
+) {
+  if(error > result->max_error) {
+    result->max_error = error;
+  }
+  if(bad) {
+    if(result->mismatches == 0) {
+      result->first_mismatch = index;
+    }
+    result->mismatches++;
+  }
+}
+
+/**
+ * @brief Scalar absolute/relative check, NaN is never within tolerance.
+ * Equal elements are, even infinities whose difference would be NaN.
+ * Unequal ones with an infinite error never are, since a relative bound
+ * scaled by an infinity would let them through
+ */
+static inline void _cspec_tolerance_check(
+  _cspec_tolerance_result *result,
+  size_t index,
+  double actual,
+  double expected,
+  cspec_tolerance tolerance
+) {
+  double error = cspec_fabs(actual - expected);
+  double bound = tolerance.value;
+
+  if(actual == expected) {
+    _cspec_tolerance_account(result, index, 0, 0);
+  } else if(!(error <= DBL_MAX)) {
+    _cspec_tolerance_account(result, index, error, 1);
+  } else if(tolerance.mode == CSPEC_TOLERANCE_RELATIVE) {
+    double scale = cspec_fabs(actual) > cspec_fabs(expected)
+                     ? cspec_fabs(actual)
+                     : cspec_fabs(expected);
+    bound *= scale;
+    _cspec_tolerance_account(
+      result, index, scale > 0 ? error / scale : 0, !(error <= bound)
+    );
+  } else {
+    _cspec_tolerance_account(result, index, error, !(error <= bound));
+  }
+}
+
+/**
+ * @brief Maps the bits of a float onto a monotonic integer line, so that
+ * the distance between two of them is their distance in ulps
+ */
+static inline unsigned long long _cspec_double_ulps(double a, double b) {
+  long long ia;
+  long long ib;
+  memcpy(&ia, &a, sizeof(ia));
+  memcpy(&ib, &b, sizeof(ib));
+  if(ia < 0) {
+    ia = LLONG_MIN - ia;
+  }
+  if(ib < 0) {
+    ib = LLONG_MIN - ib;
+  }
+  return ia > ib ? (unsigned long long)ia - (unsigned long long)ib
+                 : (unsigned long long)ib - (unsigned long long)ia;
+}
+static inline unsigned long _cspec_float_ulps(float a, float b) {
+  int ia;
+  int ib;
+  memcpy(&ia, &a, sizeof(ia));
+  memcpy(&ib, &b, sizeof(ib));
+  if(ia < 0) {
+    ia = INT_MIN - ia;
+  }
+  if(ib < 0) {
+    ib = INT_MIN - ib;
+  }
+  return ia > ib ? (unsigned long)((unsigned int)ia - (unsigned int)ib)
+                 : (unsigned long)((unsigned int)ib - (unsigned int)ia);
+}
+
+#if defined(__SSE2__)
+/**
+ * @brief Checks the two double lanes starting at index, the same way
+ * _cspec_tolerance_check does for one element
+ */
+static inline void _cspec_tolerance_check_lanes(
+  _cspec_tolerance_result *result,
+  size_t index,
+  __m128d a,
+  __m128d e,
+  cspec_tolerance tolerance,
+  __m128d *max_error
+) {
+  const __m128d sign = _mm_set1_pd(-0.0);
+  __m128d equal      = _mm_cmpeq_pd(a, e);
+  __m128d error      = _mm_andnot_pd(equal, _mm_sub_pd(a, e));
+  __m128d bound      = _mm_set1_pd(tolerance.value);
+  __m128d infinite;
+  int bad;
+
+  /* Equal lanes are cleared to an error of 0 and never count as bad, while
+   * an infinite or NaN error always does, whatever the bound */
+  error    = _mm_andnot_pd(sign, error);
+  infinite = _mm_cmpnle_pd(error, _mm_set1_pd(DBL_MAX));
+
+  if(tolerance.mode == CSPEC_TOLERANCE_RELATIVE) {
+    __m128d scale = _mm_max_pd(_mm_andnot_pd(sign, a), _mm_andnot_pd(sign, e));
+    __m128d ratio = _mm_div_pd(error, scale);
+
+    bound      = _mm_mul_pd(bound, scale);
+    ratio      = _mm_or_pd(
+      _mm_and_pd(infinite, error), _mm_andnot_pd(infinite, ratio)
+    );
+    *max_error = _mm_max_pd(ratio, *max_error);
+  } else {
+    *max_error = _mm_max_pd(error, *max_error);
+  }
+
+  bad = _mm_movemask_pd(_mm_andnot_pd(
+    equal, _mm_or_pd(infinite, _mm_cmpnle_pd(error, bound))
+  ));
+  if(bad) {
+    if(result->mismatches == 0) {
+      result->first_mismatch = index + ((bad & 1) ? 0 : 1);
+    }
+    result->mismatches += (size_t)((bad & 1) + (bad >> 1));
+  }
+}
+#endif
+
+/**
+ * @brief Compares two double arrays under a tolerance. Absolute and relative
+ * modes run two lanes at a time with SSE2 when it is available, without an
+ * early exit, so the whole array contributes to the mismatch count and the
+ * max error
+ */
+static inline _cspec_tolerance_result _cspec_compare_doubles(
+  const double *actual,
+  const double *expected,
+  size_t len,
+  cspec_tolerance tolerance
+) {
+  _cspec_tolerance_result result;
+  size_t i = 0;
+
+  result.mismatches     = 0;
+  result.first_mismatch = 0;
+  result.max_error      = 0;
+
+  if(tolerance.mode == CSPEC_TOLERANCE_ULP) {
+    for(; i < len; i++) {
+      unsigned long long ulps = _cspec_double_ulps(actual[i], expected[i]);
+      int is_nan = actual[i] != actual[i] || expected[i] != expected[i];
+      _cspec_tolerance_account(
+        &result, i, (double)ulps, is_nan || (double)ulps > tolerance.value
+      );
+    }
+    return result;
+  }
+
+#if defined(__SSE2__)
+  {
+    __m128d max_error = _mm_setzero_pd();
+    double lanes[2];
+
+    for(; i + 2 <= len; i += 2) {
+      _cspec_tolerance_check_lanes(
+        &result,
+        i,
+        _mm_loadu_pd(actual + i),
+        _mm_loadu_pd(expected + i),
+        tolerance,
+        &max_error
+      );
+    }
+
+    _mm_storeu_pd(lanes, max_error);
+    result.max_error = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+  }
+#endif
+
+  for(; i < len; i++) {
+    _cspec_tolerance_check(&result, i, actual[i], expected[i], tolerance);
+  }
+  return result;
+}
+
+/**
+ * @brief The single precision counterpart, four floats at a time widened
+ * to double, so that every element is judged like the scalar tail judges it
+ */
+static inline _cspec_tolerance_result _cspec_compare_floats(
+  const float *actual,
+  const float *expected,
+  size_t len,
+  cspec_tolerance tolerance
+) {
+  _cspec_tolerance_result result;
+  size_t i = 0;
+
+  result.mismatches     = 0;
+  result.first_mismatch = 0;
+  result.max_error      = 0;
+
+  if(tolerance.mode == CSPEC_TOLERANCE_ULP) {
+    for(; i < len; i++) {
+      unsigned long ulps = _cspec_float_ulps(actual[i], expected[i]);
+      int is_nan = actual[i] != actual[i] || expected[i] != expected[i];
+      _cspec_tolerance_account(
+        &result, i, (double)ulps, is_nan || (double)ulps > tolerance.value
+      );
+    }
+    return result;
+  }
+
+#if defined(__SSE2__)
+  {
+    __m128d max_error = _mm_setzero_pd();
+    double lanes[2];
+
+    for(; i + 4 <= len; i += 4) {
+      __m128 a = _mm_loadu_ps(actual + i);
+      __m128 e = _mm_loadu_ps(expected + i);
+
+      _cspec_tolerance_check_lanes(
+        &result, i, _mm_cvtps_pd(a), _mm_cvtps_pd(e), tolerance, &max_error
+      );
+      _cspec_tolerance_check_lanes(
+        &result,
+        i + 2,
+        _mm_cvtps_pd(_mm_movehl_ps(a, a)),
+        _mm_cvtps_pd(_mm_movehl_ps(e, e)),
+        tolerance,
+        &max_error
+      );
+    }
+
+    _mm_storeu_pd(lanes, max_error);
+    result.max_error = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+  }
+#endif
+
+  for(; i < len; i++) {
+    _cspec_tolerance_check(&result, i, actual[i], expected[i], tolerance);
+  }
+  return result;
+}
+
+#define _cspec_write_tolerance_summary(len_of_array, tolerance, result) \
+  do {                                                                  \
+    if((result).mismatches > 0) {                                       \
+      _cspec_string_addf(                                               \
+        cspec->test_result_message,                                     \
+        "%s        |> %zu of %zu elements outside %s tolerance %g, "    \
+        "max error %g, first at index %zu\n",                           \
+        cspec->display_tab,                                             \
+        (result).mismatches,                                            \
+        (size_t)(len_of_array),                                         \
+        _cspec_tolerance_name(tolerance),                               \
+        (tolerance).value,                                              \
+        (result).max_error,                                             \
+        (result).first_mismatch                                         \
+      );                                                                \
+    } else {                                                            \
+      _cspec_string_addf(                                               \
+        cspec->test_result_message,                                     \
+        "%s        |> all %zu elements within %s tolerance %g, "        \
+        "max error %g\n",                                               \
+        cspec->display_tab,                                             \
+        (size_t)(len_of_array),                                         \
+        _cspec_tolerance_name(tolerance),                               \
+        (tolerance).value,                                              \
+        (result).max_error                                              \
+      );                                                                \
+    }                                                                   \
+  } while(0)
+
+#define _cspec_assert_that_array_within(                               \
+  actual,                                                              \
+  expected,                                                            \
+  len_of_array,                                                        \
+  tolerance,                                                           \
+  _format,                                                             \
+  kernel,                                                              \
+  output_function                                                      \
+)                                                                      \
+  do {                                                                 \
+    _cspec_tolerance_result result =                                   \
+      kernel(actual, expected, len_of_array, tolerance);               \
+    if(result.mismatches > 0) {                                        \
+      _cspec_assert_array_body(                                        \
+        actual, expected, len_of_array, result.first_mismatch, _format \
+      );                                                               \
+      output_function();                                               \
+      _cspec_write_tolerance_summary(len_of_array, tolerance, result); \
+    }                                                                  \
+  } while(0)
+
+#define _cspec_nassert_that_array_within(                                   \
+  actual,                                                                   \
+  expected,                                                                 \
+  len_of_array,                                                             \
+  tolerance,                                                                \
+  _format,                                                                  \
+  kernel,                                                                   \
+  output_function                                                           \
+)                                                                           \
+  do {                                                                      \
+    _cspec_tolerance_result result =                                        \
+      kernel(actual, expected, len_of_array, tolerance);                    \
+    if(result.mismatches == 0) {                                            \
+      _cspec_assert_array_body(actual, expected, len_of_array, 0, _format); \
+      output_function();                                                    \
+      _cspec_write_tolerance_summary(len_of_array, tolerance, result);      \
+    }                                                                       \
+  } while(0)
+
 #define _cspec_float_comparison(actual, expected) \
   (cspec_fabs(actual - expected) > 1E-12)
 #define assert_that_float(inner)   \
@@ -1609,6 +5948,42 @@ _nassert_that_float_array(float *actual, float *expected, size_t len) {
     actual, expected, len, "%g", _cspec_float_comparison, _cspec_write_nassert
   );
 }
+#define assert_that_float_array_within(inner) \
+  do {                                        \
+    _cspec_clear_assertion_data();            \
+    _assert_that_float_array_within(inner);   \
+  } while(0)
+#define nassert_that_float_array_within(inner) \
+  do {                                         \
+    _cspec_clear_assertion_data();             \
+    _nassert_that_float_array_within(inner);   \
+  } while(0)
+static inline void _assert_that_float_array_within(
+  float *actual, float *expected, size_t len, cspec_tolerance tolerance
+) {
+  _cspec_assert_that_array_within(
+    actual,
+    expected,
+    len,
+    tolerance,
+    "%g",
+    _cspec_compare_floats,
+    _cspec_write_assert
+  );
+}
+static inline void _nassert_that_float_array_within(
+  float *actual, float *expected, size_t len, cspec_tolerance tolerance
+) {
+  _cspec_nassert_that_array_within(
+    actual,
+    expected,
+    len,
+    tolerance,
+    "%g",
+    _cspec_compare_floats,
+    _cspec_write_nassert
+  );
+}
 
 #define _cspec_double_comparison(actual, expected) \
   (cspec_fabs(actual - expected) > 1E-12)
@@ -1654,6 +6029,42 @@ _nassert_that_double_array(double *actual, double *expected, size_t len) {
     actual, expected, len, "%g", _cspec_double_comparison, _cspec_write_nassert
   );
 }
+#define assert_that_double_array_within(inner) \
+  do {                                         \
+    _cspec_clear_assertion_data();             \
+    _assert_that_double_array_within(inner);   \
+  } while(0)
+#define nassert_that_double_array_within(inner) \
+  do {                                          \
+    _cspec_clear_assertion_data();              \
+    _nassert_that_double_array_within(inner);   \
+  } while(0)
+static inline void _assert_that_double_array_within(
+  double *actual, double *expected, size_t len, cspec_tolerance tolerance
+) {
+  _cspec_assert_that_array_within(
+    actual,
+    expected,
+    len,
+    tolerance,
+    "%g",
+    _cspec_compare_doubles,
+    _cspec_write_assert
+  );
+}
+static inline void _nassert_that_double_array_within(
+  double *actual, double *expected, size_t len, cspec_tolerance tolerance
+) {
+  _cspec_nassert_that_array_within(
+    actual,
+    expected,
+    len,
+    tolerance,
+    "%g",
+    _cspec_compare_doubles,
+    _cspec_write_nassert
+  );
+}
 
 #define _cspec_long_double_comparison(actual, expected) \
   (cspec_fabs(actual - expected) > 1E-12)
@@ -1718,9 +6129,94 @@ static inline void _nassert_that_long_double_array(
   );
 }
 
-#define _cspec_charptr_comparison(actual, expected) \
-  (strlen(actual) != strlen(expected) ||            \
-   strncmp(expected, actual, strlen(expected)))
+/**
+ * @brief The number of bytes rendered on each side of the first difference
+ */
+#ifndef CSPEC_STRING_WINDOW
+  #define CSPEC_STRING_WINDOW 32
+#endif
+
+/**
+ * @brief Finds the first byte where two NUL terminated strings differ,
+ * only called once they are known to be different
+ */
+static size_t
+_cspec_charptr_difference(const char *actual, const char *expected) {
+  size_t offset = 0;
+  while(actual[offset] == expected[offset] && actual[offset] != '\0') {
+    offset++;
+  }
+  return offset;
+}
+
+/**
+ * @brief The length of `str` as far as an excerpt around `offset` can see.
+ * Reports one byte past the window when the string keeps going
+ */
+static size_t _cspec_charptr_excerpt_length(const char *str, size_t offset) {
+  const char *nul =
+    (const char *)memchr(str + offset, '\0', CSPEC_STRING_WINDOW + 1);
+  return nul ? (size_t)(nul - str) : offset + CSPEC_STRING_WINDOW + 1;
+}
+
+/**
+ * @brief Appends at most `CSPEC_STRING_WINDOW` bytes on each side of
+ * `offset`. Unprintable bytes are escaped so binary payloads stay readable
+ */
+static void _cspec_string_add_excerpt(
+  char **self, const char *str, size_t len, size_t offset
+) {
+  char excerpt[4 * 2 * CSPEC_STRING_WINDOW + 1];
+  size_t size  = 0;
+  size_t start = 0;
+  size_t end   = offset + CSPEC_STRING_WINDOW;
+  size_t i;
+
+  if(offset > CSPEC_STRING_WINDOW) {
+    start = offset - CSPEC_STRING_WINDOW;
+  }
+  if(end > len) {
+    end = len;
+  }
+
+  for(i = start; i < end; i++) {
+    unsigned char c = (unsigned char)str[i];
+    if(c >= 0x20 && c < 0x7f) {
+      excerpt[size++] = (char)c;
+    } else {
+      size += (size_t)sprintf(excerpt + size, "\\x%02x", c);
+    }
+  }
+  excerpt[size] = '\0';
+
+  __cspec_string_internal_addf(
+    self, "%s%s%s", start > 0 ? "..." : "", excerpt, end < len ? "..." : ""
+  );
+}
+
+/**
+ * @brief Renders both excerpts and reports where the strings diverge
+ */
+#define _cspec_write_charptr_difference(                                     \
+  actual, actual_len, expected, expected_len, offset, output_function        \
+)                                                                            \
+  do {                                                                       \
+    _cspec_string_add_excerpt(                                               \
+      &cspec->current_actual, (actual), (actual_len), (offset)               \
+    );                                                                       \
+    _cspec_string_add_excerpt(                                               \
+      &cspec->current_expected, (expected), (expected_len), (offset)         \
+    );                                                                       \
+    output_function();                                                       \
+    _cspec_string_addf(                                                      \
+      cspec->test_result_message,                                            \
+      "%s        |> strings differ at byte offset %zu\n",                    \
+      cspec->display_tab,                                                    \
+      (size_t)(offset)                                                       \
+    );                                                                       \
+  } while(0)
+
+#define _cspec_charptr_comparison(actual, expected) strcmp(actual, expected)
 #define assert_that_charptr(inner) \
   do {                             \
     _cspec_clear_assertion_data(); \
@@ -1731,6 +6227,16 @@ static inline void _nassert_that_long_double_array(
     _cspec_clear_assertion_data();  \
     _nassert_that_charptr(inner);   \
   } while(0)
+#define assert_that_charptr_n(inner) \
+  do {                               \
+    _cspec_clear_assertion_data();   \
+    _assert_that_charptr_n(inner);   \
+  } while(0)
+#define nassert_that_charptr_n(inner) \
+  do {                                \
+    _cspec_clear_assertion_data();    \
+    _nassert_that_charptr_n(inner);   \
+  } while(0)
 #define assert_that_charptr_array(inner) \
   do {                                   \
     _cspec_clear_assertion_data();       \
@@ -1741,17 +6247,70 @@ static inline void _nassert_that_long_double_array(
     _cspec_clear_assertion_data();        \
     _nassert_that_charptr_array(inner);   \
   } while(0)
+
+/**
+ * @brief A passing assertion is a single `strcmp`, the failing one walks
+ * up to the first difference and renders a short excerpt around it
+ */
 static inline void
 _assert_that_charptr(const char *actual, const char *expected) {
-  _cspec_assert_that(
-    actual, expected, "%s", _cspec_charptr_comparison, _cspec_write_assert
-  );
+  if(_cspec_charptr_comparison(actual, expected)) {
+    size_t offset = _cspec_charptr_difference(actual, expected);
+    _cspec_write_charptr_difference(
+      actual,
+      _cspec_charptr_excerpt_length(actual, offset),
+      expected,
+      _cspec_charptr_excerpt_length(expected, offset),
+      offset,
+      _cspec_write_assert
+    );
+  }
 }
 static inline void
 _nassert_that_charptr(const char *actual, const char *expected) {
-  _cspec_assert_that(
-    actual, expected, "%s", !_cspec_charptr_comparison, _cspec_write_nassert
-  );
+  if(!_cspec_charptr_comparison(actual, expected)) {
+    _cspec_string_add_excerpt(
+      &cspec->current_actual,
+      actual,
+      _cspec_charptr_excerpt_length(actual, 0),
+      0
+    );
+    _cspec_string_add_excerpt(
+      &cspec->current_expected,
+      expected,
+      _cspec_charptr_excerpt_length(expected, 0),
+      0
+    );
+    _cspec_write_nassert();
+  }
+}
+
+/**
+ * @brief Compares exactly `len` bytes, embedded NULs included, with one
+ * `memcmp`. Failures report the offset and an excerpt like `charptr` does
+ */
+static inline void
+_assert_that_charptr_n(const char *actual, const char *expected, size_t len) {
+  if(len > 0 && memcmp(actual, expected, len)) {
+    size_t offset = _cspec_first_mismatch(actual, expected, len, 1);
+    _cspec_write_charptr_difference(
+      actual, len, expected, len, offset, _cspec_write_assert
+    );
+  }
+}
+static inline void
+_nassert_that_charptr_n(const char *actual, const char *expected, size_t len) {
+  if(len == 0 || !memcmp(actual, expected, len)) {
+    _cspec_string_add_excerpt(&cspec->current_actual, actual, len, 0);
+    _cspec_string_add_excerpt(&cspec->current_expected, expected, len, 0);
+    _cspec_write_nassert();
+    _cspec_string_addf(
+      cspec->test_result_message,
+      "%s        |> all %zu bytes are equal\n",
+      cspec->display_tab,
+      len
+    );
+  }
 }
 static inline void
 _assert_that_charptr_array(char **actual, char **expected, size_t len) {
@@ -8,8 +8,8 @@
 #include "./xdecribexcontext.module.spec.h"
 #include "./xexample.module.spec.h"
 
-int main(void) {
-  cspec_run_suite("all", {
+int main(int argc, char **argv) {
+  cspec_run_suite_argv(argc, argv, {
     T_primes();
     T_simple();
     T_second();
@@ -0,0 +1,87 @@
+#ifndef __ARENA_MODULE_SPEC_H_
+#define __ARENA_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+module(T_asserting_suite, {
+  it("passes many assertions", {
+    int i;
+    for(i = 0; i < 1000; i++) {
+      assert_that_int(i equals to i);
+    }
+  });
+
+  it("fails many assertions", {
+    int i;
+    for(i = 0; i < 1000; i++) {
+      assert_that_int(i equals to -1);
+    }
+    printf(
+      "<message %zu>\n", _cspec_string_size(cspec->test_result_message)
+    );
+  });
+})
+
+/**
+ * @brief An operand several times longer than any buffer a string starts
+ * out with, ending in a marker so a cut off copy is easy to tell apart
+ */
+static const char *long_operand(void) {
+  static char operand[20001];
+
+  memset(operand, 'x', sizeof(operand) - 7);
+  memcpy(operand + sizeof(operand) - 7, "<end>", 6);
+  return operand;
+}
+
+/**
+ * @brief Reads the number the last nested suite printed after a marker
+ */
+static size_t nested_number(const char *marker) {
+  const char *at = strstr(nested.output, marker);
+  return at != NULL ? (size_t)strtoull(at + strlen(marker), NULL, 10) : 0;
+}
+
+module(T_arena, {
+  describe("the arena of framework strings", {
+    const char *arguments[] = {"nested", "--type=passing", NULL};
+
+    it("holds no more than the message of the failing assertions", {
+      size_t message;
+
+      run_nested_main(&T_asserting_suite, arguments);
+      message = nested_number("<message ");
+      assert_that(message > 0);
+      assert_that(nested_number("high-water mark ") <= 2 * message + 1024);
+    });
+
+    it("stays empty across passing assertions", {
+      const char *filter[] = {
+        "nested", "--type=passing", "--filter=passes", NULL
+      };
+      run_nested_main(&T_asserting_suite, filter);
+
+      assert_that_int(nested.counters.passing equals to 1);
+      assert_that_int(nested_number("high-water mark ") equals to 0);
+      assert_that_int(nested_number(" bytes in ") equals to 1);
+    });
+  });
+
+  describe("formatting framework strings", {
+    it("keeps an operand longer than the spare capacity whole", {
+      const char *operand = long_operand();
+      char *text          = NULL;
+
+      _cspec_string_add(text, "<");
+      _cspec_string_addf(text, "%s>", operand);
+
+      assert_that_int(_cspec_string_size(text) equals to strlen(operand) + 2);
+      assert_that(text[0] == '<');
+      assert_that(!strncmp(text + 1, operand, strlen(operand)));
+      assert_that(!strcmp(text + 1 + strlen(operand), ">"));
+    });
+  });
+})
+
+#endif
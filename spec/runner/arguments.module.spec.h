@@ -0,0 +1,135 @@
+#ifndef __ARGUMENTS_MODULE_SPEC_H_
+#define __ARGUMENTS_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+module(T_mixed_suite, {
+  it("passes quietly", { printf("<quiet test>\n"); });
+  it("fails loudly", { assert_that(1 isnot 1); });
+})
+
+module(T_every_result_suite, {
+  it("passes quietly", { assert_that(1 is 1); });
+  it("fails loudly", { assert_that(1 isnot 1); });
+  xit("is skipped for now", { assert_that(1 is 1); });
+})
+
+module(T_arguments, {
+  describe("running a suite from the command line", {
+    it("exits with the status of the tests", {
+      const char *failing[] = {"nested", NULL};
+      const char *passing[] = {"nested", "--filter=quietly", NULL};
+
+      run_nested_main(&T_mixed_suite, failing);
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.failing equals to 1);
+      run_nested_main(&T_mixed_suite, passing);
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested.counters.tests equals to 1);
+    });
+
+    it("exits with 2 for an unknown argument", {
+      const char *arguments[] = {"nested", "--frobnicate", NULL};
+      run_nested_main(&T_mixed_suite, arguments);
+
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      assert_that(!nested_printed("<quiet test>"));
+    });
+
+    it("exits with 2 for a malformed option", {
+      const char *valued[]   = {"nested", "--fail-fast=yes", NULL};
+      const char *bare[]     = {"nested", "--jobs", NULL};
+      const char *positive[] = {"nested", "vector", NULL};
+      const char *typed[]    = {"nested", "--type=everything", NULL};
+
+      run_nested_main(&T_mixed_suite, valued);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      run_nested_main(&T_mixed_suite, bare);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      run_nested_main(&T_mixed_suite, positive);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      run_nested_main(&T_mixed_suite, typed);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+    });
+
+    it("exits with 2 for a number it cannot read", {
+      const char *jobs[]    = {"nested", "--jobs=abc", NULL};
+      const char *seed[]    = {"nested", "--seed=xyz", NULL};
+      const char *isolate[] = {"nested", "--isolate=4x", NULL};
+      const char *options[] = {"CSPEC_JOBS=abc", NULL};
+
+      run_nested_main(&T_mixed_suite, jobs);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      assert_that(!nested_printed("<quiet test>"));
+      run_nested_main(&T_mixed_suite, seed);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      run_nested_main(&T_mixed_suite, isolate);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      run_nested_suite(&T_mixed_suite, options);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+    });
+
+    it("prints every option for `--help` without running the suite", {
+      const char *arguments[] = {"nested", "--help", NULL};
+      run_nested_main(&T_mixed_suite, arguments);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that(nested_printed("--isolate-batch=value"));
+      assert_that(nested_printed("--rerun-failed "));
+      assert_that(!nested_printed("<quiet test>"));
+    });
+
+    it("only prints the results asked for with `--type`", {
+      const char *arguments[] = {"nested", "--type=failing", NULL};
+      run_nested_main(&T_mixed_suite, arguments);
+
+      assert_that_int(nested.counters.passing equals to 1);
+      assert_that(nested_printed("fails loudly"));
+      assert_that(!nested_printed("passes quietly"));
+    });
+
+    it("prints each kind of result of a `--type` combination", {
+      const char *arguments[] = {"nested", "--type=failing,skipped", NULL};
+      run_nested_main(&T_every_result_suite, arguments);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.tests equals to 3);
+      assert_that(nested_printed("fails loudly"));
+      assert_that(nested_printed("is skipped for now"));
+      assert_that(!nested_printed("passes quietly"));
+    });
+
+    it("exits with 2 for a `--type` combination it cannot read", {
+      const char *unknown[] = {"nested", "--type=failing,everything", NULL};
+      const char *empty[]   = {"nested", "--type=passing,,skipped", NULL};
+
+      run_nested_main(&T_every_result_suite, unknown);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      assert_that(!nested_printed("fails loudly"));
+      run_nested_main(&T_every_result_suite, empty);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      assert_that(!nested_printed("passes quietly"));
+    });
+
+    it("writes the report to the file given with `--output`", {
+      char report[64];
+      char output_argument[80];
+      char contents[4096];
+      const char *arguments[] = {"nested", output_argument, NULL};
+
+      nested_file(report, sizeof(report), "report");
+      snprintf(
+        output_argument, sizeof(output_argument), "--output=%s", report
+      );
+      run_nested_main(&T_mixed_suite, arguments);
+
+      assert_that_int(nested.length equals to 0);
+      nested_read_file(report, contents, sizeof(contents));
+      assert_that(strstr(contents, "fails loudly"));
+      remove(report);
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __CRASHES_MODULE_SPEC_H_
+#define __CRASHES_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+module(T_crashing_suite, {
+  it("segfaults", { raise(SIGSEGV); });
+  it("aborts", { abort(); });
+  it("passes after the crashes", { printf("<after the crashes>\n"); });
+})
+
+module(T_crashes, {
+  describe("catching crashes inside tests", {
+    it("fails the tests that crash", {
+      const char *options[] = {"CSPEC_CATCH_CRASHES=1", NULL};
+      run_nested_suite(&T_crashing_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.failing equals to 2);
+      assert_that(nested_printed("crashed with SIGSEGV (signal"));
+      assert_that(nested_printed("crashed with SIGABRT (signal"));
+    });
+
+    it("goes on with the next test", {
+      const char *options[] = {"CSPEC_CATCH_CRASHES=1", NULL};
+      run_nested_suite(&T_crashing_suite, options);
+
+      assert_that_int(nested.counters.passing equals to 1);
+      assert_that(nested_printed("<after the crashes>"));
+    });
+
+    it("lets a crash end the suite without CSPEC_CATCH_CRASHES", {
+      const char *options[] = {NULL};
+      run_nested_suite(&T_crashing_suite, options);
+
+      assert_that_int(nested.status equals to -1);
+      assert_that(!nested_printed("<after the crashes>"));
+    });
+  });
+})
+
+#endif
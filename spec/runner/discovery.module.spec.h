@@ -0,0 +1,56 @@
+#ifndef __DISCOVERY_MODULE_SPEC_H_
+#define __DISCOVERY_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+static void shared_examples(void) {
+  it("runs a test written in a helper", { printf("<helper body>\n"); });
+}
+
+module(T_discovered_suite, {
+  describe("outer", {
+    it("runs the first test", { printf("<first body>\n"); });
+    context("inner", {
+      it("runs the second test", { printf("<second body>\n"); });
+      shared_examples();
+    });
+  });
+})
+
+module(T_discovery, {
+  describe("discovering the tree of a suite", {
+    it("lists every block instead of running the tests", {
+      const char *options[] = {"CSPEC_LIST=1", NULL};
+      run_nested_suite(&T_discovered_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested.counters.tests equals to 0);
+      assert_that(nested_printed("runs the first test"));
+      assert_that(nested_printed("runs a test written in a helper"));
+      assert_that(!nested_printed(" body>"));
+    });
+
+    it("runs only the tests under the block of CSPEC_ID", {
+      const char *options[] = {"CSPEC_ID=3", NULL};
+      run_nested_suite(&T_discovered_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested.counters.tests equals to 2);
+      assert_that(!nested_printed("<first body>"));
+      assert_that(nested_printed("<second body>"));
+      assert_that(nested_printed("<helper body>"));
+    });
+
+    it("finds tests that a block reaches through a function", {
+      const char *options[] = {NULL};
+      run_nested_suite(&T_discovered_suite, options);
+
+      assert_that_int(nested.counters.tests equals to 3);
+      assert_that_int(nested.counters.passing equals to 3);
+      assert_that_int(nested_count("<helper body>") equals to 1);
+    });
+  });
+})
+
+#endif
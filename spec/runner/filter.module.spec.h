@@ -0,0 +1,61 @@
+#ifndef __FILTER_MODULE_SPEC_H_
+#define __FILTER_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+module(T_filtered_suite, {
+  describe("parser", {
+    it("reads numbers", { printf("<reads numbers>\n"); });
+    it("reads words", { printf("<reads words>\n"); });
+  });
+  describe("printer", {
+    it("writes numbers", { printf("<writes numbers>\n"); });
+  });
+})
+
+module(T_filter, {
+  describe("running the tests whose path matches a filter", {
+    it("looks for a plain filter anywhere in the path", {
+      const char *options[] = {"CSPEC_FILTER=numbers", NULL};
+      run_nested_suite(&T_filtered_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested.counters.tests equals to 2);
+      assert_that(nested_printed("<reads numbers>"));
+      assert_that(nested_printed("<writes numbers>"));
+      assert_that(!nested_printed("<reads words>"));
+    });
+
+    it("takes every test of a block whose name matches", {
+      const char *options[] = {"CSPEC_FILTER=parser", NULL};
+      run_nested_suite(&T_filtered_suite, options);
+
+      assert_that_int(nested.counters.tests equals to 2);
+      assert_that(!nested_printed("<writes numbers>"));
+    });
+
+    it("matches a glob with `*` and `?` against the whole path", {
+      const char *starred[] = {"CSPEC_FILTER=*/printer/*", NULL};
+      const char *marked[]  = {"CSPEC_FILTER=*reads ?????", NULL};
+
+      run_nested_suite(&T_filtered_suite, starred);
+      assert_that_int(nested.counters.tests equals to 1);
+      assert_that(nested_printed("<writes numbers>"));
+
+      run_nested_suite(&T_filtered_suite, marked);
+      assert_that_int(nested.counters.tests equals to 1);
+      assert_that(nested_printed("<reads words>"));
+    });
+
+    it("runs nothing for a glob that only matches the middle of a path", {
+      const char *options[] = {"CSPEC_FILTER=parser*", NULL};
+      run_nested_suite(&T_filtered_suite, options);
+
+      assert_that_int(nested.counters.tests equals to 0);
+      assert_that(!nested_printed("<reads"));
+    });
+  });
+})
+
+#endif
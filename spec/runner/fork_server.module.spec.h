@@ -0,0 +1,55 @@
+#ifndef __FORK_SERVER_MODULE_SPEC_H_
+#define __FORK_SERVER_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+static int loaded_fixture = 0;
+static int batch_counter  = 0;
+
+module(T_served_suite, {
+  before({
+    loaded_fixture = 42;
+    printf("<expensive setup>\n");
+  });
+
+  it("starts from the loaded fixture", {
+    batch_counter++;
+    printf("<fixture %d, test %d>\n", loaded_fixture, batch_counter);
+  });
+  it("starts from it again", {
+    batch_counter++;
+    printf("<fixture %d, test %d>\n", loaded_fixture, batch_counter);
+  });
+  it("starts from it once more", {
+    batch_counter++;
+    printf("<fixture %d, test %d>\n", loaded_fixture, batch_counter);
+  });
+})
+
+module(T_fork_server, {
+  describe("forking isolated tests from the setup of their module", {
+    it("runs the setup once for all of its tests", {
+      const char *options[] = {"CSPEC_ISOLATE=2", NULL};
+      run_nested_suite(&T_served_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested_count("<expensive setup>") equals to 1);
+      assert_that_int(nested_count("<fixture 42, test 1>") equals to 3);
+    });
+
+    it("lets the tests of a batch share their child", {
+      const char *options[] = {
+        "CSPEC_ISOLATE=1", "CSPEC_ISOLATE_BATCH=2", NULL
+      };
+      run_nested_suite(&T_served_suite, options);
+
+      assert_that_int(nested.counters.passing equals to 3);
+      assert_that_int(nested_count("<expensive setup>") equals to 1);
+      assert_that_int(nested_count("<fixture 42, test 1>") equals to 2);
+      assert_that_int(nested_count("<fixture 42, test 2>") equals to 1);
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef __ISOLATION_MODULE_SPEC_H_
+#define __ISOLATION_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+static int isolation_counter = 0;
+
+module(T_leaking_suite, {
+  it("changes a global", {
+    isolation_counter++;
+    printf("<counter %d>\n", isolation_counter);
+  });
+  it("changes the same global", {
+    isolation_counter++;
+    printf("<counter %d>\n", isolation_counter);
+  });
+})
+
+module(T_exiting_suite, {
+  it("exits in the middle of its body", { _exit(4); });
+  it("passes after the exit", { printf("<after the exit>\n"); });
+})
+
+/* Each process keeps its own fixture file, so a test only finds one when
+ * its `before_each` ran in the same process as its body */
+static char fixture_path[64];
+
+static void fixture_create(void) {
+  FILE *fixture;
+  snprintf(
+    fixture_path, sizeof(fixture_path), "cspec_fixture_%ld", (long)getpid()
+  );
+  fixture = fopen(fixture_path, "w");
+  if(fixture) {
+    fputs("ready", fixture);
+    fclose(fixture);
+  }
+}
+
+static void fixture_remove(void) { remove(fixture_path); }
+
+static cspec_bool fixture_is_ready(void) {
+  char contents[8];
+  char path[64];
+  FILE *fixture;
+  cspec_bool ready;
+
+  snprintf(path, sizeof(path), "cspec_fixture_%ld", (long)getpid());
+  fixture = fopen(path, "r");
+  if(fixture == NULL) {
+    return _cspec_false;
+  }
+  ready = fgets(contents, sizeof(contents), fixture) != NULL &&
+          strcmp(contents, "ready") == 0;
+  fclose(fixture);
+  return ready;
+}
+
+module(T_fixture_suite, {
+  before_each(&fixture_create);
+  after_each(&fixture_remove);
+
+  describe("a fixture with a side effect", {
+    it("is set up in the process of the test", {
+      assert_that(fixture_is_ready());
+    });
+    it("is set up again for the next test", {
+      assert_that(fixture_is_ready());
+    });
+  });
+})
+
+module(T_isolation, {
+  describe("running each test in a forked child", {
+    it("shares globals between tests without CSPEC_ISOLATE", {
+      const char *options[] = {NULL};
+      run_nested_suite(&T_leaking_suite, options);
+
+      assert_that(nested_printed("<counter 2>"));
+    });
+
+    it("throws away the globals a test changed", {
+      const char *options[] = {"CSPEC_ISOLATE=1", NULL};
+      run_nested_suite(&T_leaking_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested.counters.passing equals to 2);
+      assert_that_int(nested_count("<counter 1>") equals to 2);
+      assert_that(!nested_printed("<counter 2>"));
+    });
+
+    it("fails a test whose child exited and goes on with the next", {
+      const char *options[] = {"CSPEC_ISOLATE=1", NULL};
+      run_nested_suite(&T_exiting_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that_int(nested.counters.passing equals to 1);
+      assert_that(nested_printed("<after the exit>"));
+    });
+
+    it("counts every test with a pool of children", {
+      const char *options[] = {"CSPEC_ISOLATE=4", NULL};
+      run_nested_suite(&T_exiting_suite, options);
+
+      assert_that_int(nested.counters.tests equals to 2);
+      assert_that_int(nested.counters.failing equals to 1);
+    });
+
+    it("runs `before_each` in the process of its test", {
+      const char *plain[]    = {NULL};
+      const char *isolated[] = {"CSPEC_ISOLATE=2", NULL};
+
+      run_nested_suite(&T_fixture_suite, plain);
+      assert_that_int(nested.counters.passing equals to 2);
+      run_nested_suite(&T_fixture_suite, isolated);
+      assert_that_int(nested.counters.passing equals to 2);
+      assert_that_int(nested.counters.failing equals to 0);
+    });
+  });
+})
+
+#endif
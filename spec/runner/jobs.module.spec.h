@@ -0,0 +1,120 @@
+#ifndef __JOBS_MODULE_SPEC_H_
+#define __JOBS_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./arena.module.spec.h"
+#include "./nested_suite.spec.h"
+
+#include <sys/resource.h> /* setrlimit */
+
+module(T_first_half, {
+  it("passes in the first module", { printf("<first module>\n"); });
+  it("fails in the first module", { fail("on purpose"); });
+})
+
+module(T_second_half, {
+  it("passes in the second module", { printf("<second module>\n"); });
+  it("passes again in the second module", { assert_that(1 is 1); });
+})
+
+module(T_exiting_half, {
+  it("takes its worker down", { _exit(3); });
+  it("never gets to run", { printf("<after the exit>\n"); });
+})
+
+static void T_split_suite(void) {
+  T_first_half();
+  T_second_half();
+}
+
+static void T_allocating_suite(void) {
+  T_asserting_suite();
+  T_second_half();
+}
+
+static void T_losing_suite(void) {
+  T_exiting_half();
+  T_second_half();
+}
+
+/**
+ * @brief The split suite in a child that cannot open another descriptor,
+ * so no worker gets a pipe. Only discovery calls this, before the run
+ */
+static void T_pipeless_suite(void) {
+  struct rlimit limit;
+  int lowest = dup(STDOUT_FILENO);
+
+  if(lowest >= 0) {
+    close(lowest);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = (rlim_t)lowest;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+  T_split_suite();
+}
+
+module(T_jobs, {
+  describe("spreading modules over forked workers", {
+    it("adds up the results of every worker", {
+      const char *options[] = {"CSPEC_JOBS=2", NULL};
+      run_nested_suite(&T_split_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.tests equals to 4);
+      assert_that_int(nested.counters.passing equals to 3);
+      assert_that_int(nested.counters.failing equals to 1);
+    });
+
+    it("prints the modules in the order they were discovered", {
+      const char *options[] = {"CSPEC_JOBS=2", NULL};
+      run_nested_suite(&T_split_suite, options);
+
+      assert_that(nested_printed("<first module>"));
+      assert_that(nested_printed("<second module>"));
+      assert_that(
+        strstr(nested.output, "<first module>") <
+        strstr(nested.output, "<second module>")
+      );
+    });
+
+    it("adds up the mallocs of every worker", {
+      /* Only passing tests get printed, the failing messages are long */
+      const char *sequential[] = {"nested", "--type=passing", NULL};
+      const char *jobs[]       = {
+        "nested", "--type=passing", "--jobs=2", NULL
+      };
+      size_t mallocs;
+
+      run_nested_main(&T_allocating_suite, sequential);
+      mallocs = nested_number(" bytes in ");
+      assert_that(mallocs > 1);
+      run_nested_main(&T_allocating_suite, jobs);
+      assert_that_int(nested_number(" bytes in ") equals to mallocs);
+    });
+
+    it("fails the tests of a module whose worker died", {
+      const char *options[] = {"CSPEC_JOBS=2", NULL};
+      run_nested_suite(&T_losing_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.passing equals to 2);
+      assert_that_int(nested.counters.failing equals to 2);
+      assert_that(!nested_printed("<after the exit>"));
+    });
+
+    it("runs every module itself when no worker could be started", {
+      const char *options[] = {"CSPEC_JOBS=2", NULL};
+      run_nested_suite(&T_pipeless_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.tests equals to 4);
+      assert_that_int(nested.counters.passing equals to 3);
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that(nested_printed("<first module>"));
+      assert_that(nested_printed("<second module>"));
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef __JOURNAL_MODULE_SPEC_H_
+#define __JOURNAL_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+static int journal_broken = 1;
+static CSPEC_THREAD_LOCAL char journal[64];
+static CSPEC_THREAD_LOCAL char journal_option[80];
+
+/* Named in the body, which is where isolated tests have a process */
+static void journal_file(void) {
+  nested_file(journal, sizeof(journal), "journal");
+  snprintf(journal_option, sizeof(journal_option), "CSPEC_JOURNAL=%s", journal);
+}
+
+module(T_journaled_suite, {
+  describe("a fix in progress", {
+    it("fails until it is fixed", {
+      printf("<fixed test>\n");
+      assert_that_int(journal_broken equals to 0);
+    });
+    it("passes before the fix", { printf("<passing test 1>\n"); });
+  });
+  it("passes after the fix", { printf("<passing test 2>\n"); });
+})
+
+module(T_twin_suite, {
+  it("has a twin", { assert_that_int(journal_broken equals to 0); });
+  it("has a twin", { printf("<passing twin>\n"); });
+})
+
+module(T_journal, {
+  describe("rerunning the tests that failed before", {
+    char contents[1024];
+
+    it("keeps the path and place of every failing test in the journal", {
+      const char *options[] = {journal_option, NULL};
+      journal_file();
+      journal_broken = 1;
+      run_nested_suite(&T_journaled_suite, options);
+
+      assert_that_int(
+        nested_read_file(journal, contents, sizeof(contents)) equals to 1
+      );
+      assert_that(strstr(
+        contents, " T_journaled_suite/a fix in progress/fails until it is fixed"
+      ));
+      assert_that(strstr(contents, "journal.module.spec.h:"));
+      remove(journal);
+    });
+
+    it("skips the body of every test outside the journal", {
+      const char *options[] = {journal_option, NULL};
+      const char *rerun[]   = {journal_option, "CSPEC_RERUN_FAILED=1", NULL};
+      journal_file();
+      journal_broken = 1;
+      run_nested_suite(&T_journaled_suite, options);
+      run_nested_suite(&T_journaled_suite, rerun);
+
+      assert_that_int(nested.counters.tests equals to 1);
+      assert_that(nested_printed("<fixed test>"));
+      assert_that(!nested_printed("<passing test"));
+      remove(journal);
+    });
+
+    it("tells twin tests with the same path apart by their line", {
+      const char *options[] = {journal_option, NULL};
+      const char *rerun[]   = {journal_option, "CSPEC_RERUN_FAILED=1", NULL};
+      journal_file();
+      journal_broken = 1;
+      run_nested_suite(&T_twin_suite, options);
+      run_nested_suite(&T_twin_suite, rerun);
+
+      assert_that_int(nested.counters.tests equals to 1);
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that(!nested_printed("<passing twin>"));
+      remove(journal);
+    });
+
+    it("runs everything again once the journal is empty", {
+      const char *options[] = {journal_option, NULL};
+      const char *rerun[]   = {journal_option, "CSPEC_RERUN_FAILED=1", NULL};
+      journal_file();
+      journal_broken = 1;
+      run_nested_suite(&T_journaled_suite, options);
+      journal_broken = 0;
+      run_nested_suite(&T_journaled_suite, rerun);
+
+      assert_that_int(nested.counters.passing equals to 1);
+      assert_that_int(
+        nested_read_file(journal, contents, sizeof(contents)) equals to 0
+      );
+      run_nested_suite(&T_journaled_suite, rerun);
+      assert_that_int(nested.counters.tests equals to 3);
+      remove(journal);
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef __MAX_FAILURES_MODULE_SPEC_H_
+#define __MAX_FAILURES_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./jobs.module.spec.h"
+#include "./nested_suite.spec.h"
+
+module(T_failing_suite, {
+  it("fails first", { fail("failure 1"); });
+  it("passes in between", { printf("<passing 1>\n"); });
+  it("fails second", { fail("failure 2"); });
+  it("fails third", { fail("failure 3"); });
+  it("passes at the end", { printf("<passing 2>\n"); });
+})
+
+module(T_max_failures, {
+  describe("stopping after too many failures", {
+    it("runs every test without a limit", {
+      const char *options[] = {NULL};
+      run_nested_suite(&T_failing_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.tests equals to 5);
+      assert_that_int(nested.counters.failing equals to 3);
+      assert_that(nested_printed("<passing 2>"));
+    });
+
+    it("stops at the first failure with CSPEC_FAIL_FAST", {
+      const char *options[] = {"CSPEC_FAIL_FAST=1", NULL};
+      run_nested_suite(&T_failing_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.tests equals to 1);
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that(!nested_printed("<passing 1>"));
+    });
+
+    it("stops once CSPEC_MAX_FAILURES tests failed", {
+      const char *options[] = {"CSPEC_MAX_FAILURES=2", NULL};
+      run_nested_suite(&T_failing_suite, options);
+
+      assert_that_int(nested.counters.tests equals to 3);
+      assert_that_int(nested.counters.passing equals to 1);
+      assert_that_int(nested.counters.failing equals to 2);
+      assert_that(!nested_printed("<passing 2>"));
+    });
+
+    it("does not start the modules after the limit", {
+      const char *options[] = {"CSPEC_FAIL_FAST=1", NULL};
+      run_nested_suite(&T_split_suite, options);
+
+      assert_that_int(nested.counters.tests equals to 2);
+      assert_that(nested_printed("<first module>"));
+      assert_that(!nested_printed("<second module>"));
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,286 @@
+#ifndef __NESTED_SUITE_SPEC_H_
+#define __NESTED_SUITE_SPEC_H_
+
+#include "../../src/cSpec.h"
+
+/* Runner options are read once when a suite starts, so the specs of the
+ * runner start a suite of their own in a forked child */
+
+extern char **environ;
+
+/* Strict ISO modes hide the POSIX declarations of the environment */
+#if !defined(_POSIX_C_SOURCE) && !defined(__cplusplus)
+extern int putenv(char *assignment);
+extern int unsetenv(const char *name);
+#endif
+
+/**
+ * @brief The counters a nested suite ended with, as its child reported them
+ */
+typedef struct {
+  size_t tests;
+  size_t passing;
+  size_t failing;
+  size_t skipped;
+} nested_counters;
+
+/**
+ * @brief What the last nested suite printed, the counters it ended with and
+ * the status it exited with, kept apart for every thread of the pool like
+ * the context of cspec
+ */
+static CSPEC_THREAD_LOCAL struct {
+  char output[65536];
+  size_t length;
+  nested_counters counters;
+  int status;
+} nested;
+
+/**
+ * @brief The child that runs a nested suite and the pipe it reports its
+ * counters on. Only set in that child, which has no other threads
+ */
+static pid_t nested_child;
+static int nested_counters_fd = -1;
+
+/**
+ * @brief Reports the counters of the nested suite when its child exits,
+ * whichever way the suite ended. Workers and isolated tests it forks exit
+ * on their own and leave this to the child
+ */
+static void nested_report_counters(void) {
+  nested_counters counters = {0, 0, 0, 0};
+
+  if(getpid() != nested_child) {
+    return;
+  }
+  fflush(stdout);
+  if(cspec != NULL) {
+    counters.tests   = cspec->number_of_tests;
+    counters.passing = cspec->number_of_passing_tests;
+    counters.failing = cspec->number_of_failing_tests;
+    counters.skipped = cspec->number_of_skipped_tests;
+  }
+  if(write(nested_counters_fd, &counters, sizeof(counters)) < 0) {
+    return;
+  }
+}
+
+/**
+ * @brief Forgets the options of the suite that forked, so a nested suite
+ * only sees the ones it is started with
+ */
+static void nested_forget_options(void) {
+  size_t at = 0;
+
+  while(environ[at] != NULL) {
+    char name[64];
+    size_t length = strcspn(environ[at], "=");
+
+    if(strncmp(environ[at], "CSPEC_", 6) == 0 && length < sizeof(name)) {
+      memcpy(name, environ[at], length);
+      name[length] = '\0';
+      unsetenv(name);
+    } else {
+      at++;
+    }
+  }
+  memset(_cspec_arguments, 0, sizeof(_cspec_arguments));
+}
+
+/**
+ * @brief Reads what the child of a nested suite printed and reported, then
+ * waits for it
+ * @param child -> The child running the suite
+ * @param output -> The read end of its stdout
+ * @param counters -> The read end of its counters
+ */
+static void nested_collect(pid_t child, int output, int counters) {
+  char discarded[4096];
+  int status = 0;
+  ssize_t count;
+
+  for(;;) {
+    char *buffer = nested.output + nested.length;
+    size_t space = sizeof(nested.output) - 1 - nested.length;
+
+    if(space == 0) {
+      buffer = discarded;
+      space  = sizeof(discarded);
+    }
+    count = read(output, buffer, space);
+    if(count < 0 && errno == EINTR) {
+      continue;
+    }
+    if(count <= 0) {
+      break;
+    }
+    if(buffer != discarded) {
+      nested.length += (size_t)count;
+    }
+  }
+  nested.output[nested.length] = '\0';
+  close(output);
+
+  while((count = read(counters, &nested.counters, sizeof(nested.counters))) <
+          0 &&
+        errno == EINTR) {}
+  if(count != (ssize_t)sizeof(nested.counters)) {
+    memset(&nested.counters, 0, sizeof(nested.counters));
+  }
+  close(counters);
+
+  if(child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status)) {
+    nested.status = WEXITSTATUS(status);
+  }
+}
+
+/**
+ * @brief Forks the child of a nested suite, with its stdout and counters
+ * going to pipes of the parent
+ * @return The pid of the child, which is 0 in the child itself
+ */
+static pid_t nested_fork(int *output, int *counters) {
+  int output_fds[2];
+  int counters_fds[2];
+  pid_t child;
+
+  nested.length         = 0;
+  nested.output[0]      = '\0';
+  nested.status         = -1;
+  fflush(stdout);
+  if(pipe(output_fds) != 0) {
+    return -1;
+  }
+  if(pipe(counters_fds) != 0) {
+    close(output_fds[0]);
+    close(output_fds[1]);
+    return -1;
+  }
+
+  child = fork();
+  if(child == 0) {
+    close(output_fds[0]);
+    close(counters_fds[0]);
+    dup2(output_fds[1], STDOUT_FILENO);
+    close(output_fds[1]);
+    nested_child       = getpid();
+    nested_counters_fd = counters_fds[1];
+    cspec              = NULL;
+    nested_forget_options();
+    atexit(&nested_report_counters);
+    return 0;
+  }
+
+  close(output_fds[1]);
+  close(counters_fds[1]);
+  *output   = output_fds[0];
+  *counters = counters_fds[0];
+  return child;
+}
+
+/**
+ * @brief Runs a module as a suite of its own, with runner options set in
+ * its environment
+ * @param suite -> The module to run
+ * @param options -> Assignments like "CSPEC_JOBS=2", ending in NULL
+ */
+static void run_nested_suite(void (*suite)(void), const char **options) {
+  int output;
+  int counters;
+  pid_t child = nested_fork(&output, &counters);
+
+  if(child == 0) {
+    for(; *options != NULL; options++) {
+      putenv((char *)*options);
+    }
+    cspec_run_suite("all", { suite(); });
+    exit(cspec->number_of_failing_tests > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+  }
+  if(child > 0) {
+    nested_collect(child, output, counters);
+  }
+}
+
+/**
+ * @brief Runs a module as a suite of its own with cspec_run_suite_argv
+ * @param suite -> The module to run
+ * @param arguments -> The argv of the suite, ending in NULL
+ */
+static void run_nested_main(void (*suite)(void), const char **arguments) {
+  int output;
+  int counters;
+  int argc    = 0;
+  pid_t child = nested_fork(&output, &counters);
+
+  while(arguments[argc] != NULL) {
+    argc++;
+  }
+  if(child == 0) {
+    cspec_run_suite_argv(argc, (char **)arguments, { suite(); });
+  }
+  if(child > 0) {
+    nested_collect(child, output, counters);
+  }
+}
+
+/**
+ * @brief The number of times the tests of the last nested suite printed a
+ * marker of their own
+ */
+static size_t nested_count(const char *marker) {
+  const char *at = nested.output;
+  size_t count   = 0;
+
+  while((at = strstr(at, marker)) != NULL) {
+    count++;
+    at += strlen(marker);
+  }
+  return count;
+}
+
+#define nested_printed(marker) (nested_count(marker) > 0)
+
+/**
+ * @brief A file of its own for every process and thread that runs a spec,
+ * so specs that run at the same time do not share their history or journal.
+ * Threads share the pid, so the address of their own `nested` tells them
+ * apart
+ * @param path -> Where the name is written
+ * @param size -> The size of `path`
+ * @param name -> What the file is for
+ */
+static void nested_file(char *path, size_t size, const char *name) {
+  snprintf(
+    path,
+    size,
+    "cspec_%s_%ld_%lx",
+    name,
+    (long)getpid(),
+    (unsigned long)(size_t)&nested
+  );
+  remove(path);
+}
+
+/**
+ * @brief Reads a whole file the nested suite wrote, as much as fits in
+ * `contents`
+ * @return The number of lines in it
+ */
+static size_t nested_read_file(const char *path, char *contents, size_t size) {
+  size_t length = 0;
+  size_t lines  = 0;
+  FILE *file    = fopen(path, "r");
+
+  if(file != NULL) {
+    length = fread(contents, 1, size - 1, file);
+    fclose(file);
+  }
+  contents[length] = '\0';
+  while(length > 0) {
+    lines += contents[--length] == '\n';
+  }
+  return lines;
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef __RANDOM_ORDER_MODULE_SPEC_H_
+#define __RANDOM_ORDER_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+module(T_shuffled_first, {
+  before({ printf("<module 1>\n"); });
+  after({ printf("<after>\n"); });
+
+  describe("alpha", {
+    int prepared;
+
+    before({
+      prepared = 1;
+      printf("<alpha>\n");
+    });
+    it("runs test 1", {
+      assert_that_int(prepared equals to 1);
+      prepared = 2;
+      printf("<test 1>\n");
+    });
+    it("runs test 2", {
+      assert_that_int(prepared equals to 1);
+      prepared = 2;
+      printf("<test 2>\n");
+    });
+    after({ printf("<after alpha>\n"); });
+  });
+  it("runs test 3", { printf("<test 3>\n"); });
+  it("runs test 4", { printf("<test 4>\n"); });
+})
+
+module(T_shuffled_second, {
+  before({ printf("<module 2>\n"); });
+  it("runs a test", { assert_that(1 is 1); });
+})
+
+module(T_shuffled_third, {
+  before({ printf("<module 3>\n"); });
+  it("runs a test", { assert_that(1 is 1); });
+})
+
+module(T_shuffled_fourth, {
+  before({ printf("<module 4>\n"); });
+  it("runs a test", { assert_that(1 is 1); });
+})
+
+static void T_shuffled_suite(void) {
+  T_shuffled_first();
+  T_shuffled_second();
+  T_shuffled_third();
+  T_shuffled_fourth();
+}
+
+/**
+ * @brief Notes the order the nested suite first printed numbered markers in
+ * @param order -> Gets the number of every marker, as it first showed up
+ * @param prefix -> The markers to look for, like "<module "
+ */
+static void shuffled_markers(char order[8], const char *prefix) {
+  const char *marker = nested.output;
+  size_t length      = 0;
+
+  while((marker = strstr(marker, prefix)) != NULL && length < 7) {
+    marker += strlen(prefix);
+    if(memchr(order, *marker, length) == NULL) {
+      order[length++] = *marker;
+    }
+  }
+  order[length] = '\0';
+}
+
+#define shuffled_order(order) shuffled_markers(order, "<module ")
+
+module(T_random_order, {
+  describe("running the modules in a random order", {
+    char order[8];
+    char replayed[8];
+
+    it("runs every module once", {
+      const char *options[] = {"CSPEC_ORDER=random", "CSPEC_SEED=7", NULL};
+      run_nested_suite(&T_shuffled_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested.counters.tests equals to 7);
+      shuffled_order(order);
+      assert_that_int(strlen(order) equals to 4);
+      assert_that(strchr(order, '1') && strchr(order, '2'));
+      assert_that(strchr(order, '3') && strchr(order, '4'));
+    });
+
+    it("replays the same order from the same seed", {
+      const char *options[] = {"CSPEC_ORDER=random", "CSPEC_SEED=7", NULL};
+      const char *seeded[]  = {"CSPEC_SEED=7", NULL};
+
+      run_nested_suite(&T_shuffled_suite, options);
+      shuffled_order(order);
+      run_nested_suite(&T_shuffled_suite, options);
+      shuffled_order(replayed);
+      assert_that_charptr(replayed equals to order);
+      run_nested_suite(&T_shuffled_suite, seeded);
+      shuffled_order(replayed);
+      assert_that_charptr(replayed equals to order);
+    });
+
+    it("moves modules away from the order they are written in", {
+      const char *options[][3] = {
+        {"CSPEC_ORDER=random", "CSPEC_SEED=1", NULL},
+        {"CSPEC_ORDER=random", "CSPEC_SEED=2", NULL},
+        {"CSPEC_ORDER=random", "CSPEC_SEED=3", NULL},
+      };
+      size_t shuffled = 0;
+      size_t run;
+
+      for(run = 0; run < 3; run++) {
+        run_nested_suite(&T_shuffled_suite, options[run]);
+        shuffled_order(order);
+        shuffled += strcmp(order, "1234") != 0;
+      }
+      assert_that(shuffled isnot 0);
+    });
+
+    it("moves the tests of a module away from the order they are written in", {
+      const char *options[][3] = {
+        {"CSPEC_ORDER=random", "CSPEC_SEED=1", NULL},
+        {"CSPEC_ORDER=random", "CSPEC_SEED=2", NULL},
+        {"CSPEC_ORDER=random", "CSPEC_SEED=3", NULL},
+      };
+      size_t shuffled = 0;
+      size_t run;
+
+      for(run = 0; run < 3; run++) {
+        run_nested_suite(&T_shuffled_suite, options[run]);
+        shuffled_markers(order, "<test ");
+        assert_that_int(strlen(order) equals to 4);
+        shuffled += strcmp(order, "1234") != 0;
+      }
+      assert_that(shuffled isnot 0);
+    });
+
+    it("replays the same order of tests from the same seed", {
+      const char *options[] = {"CSPEC_ORDER=random", "CSPEC_SEED=7", NULL};
+
+      run_nested_suite(&T_shuffled_suite, options);
+      shuffled_markers(order, "<test ");
+      run_nested_suite(&T_shuffled_suite, options);
+      shuffled_markers(replayed, "<test ");
+      assert_that_charptr(replayed equals to order);
+    });
+
+    it("keeps the tests of a describe next to each other", {
+      const char *options[][3] = {
+        {"CSPEC_ORDER=random", "CSPEC_SEED=1", NULL},
+        {"CSPEC_ORDER=random", "CSPEC_SEED=2", NULL},
+        {"CSPEC_ORDER=random", "CSPEC_SEED=3", NULL},
+      };
+      size_t run;
+
+      for(run = 0; run < 3; run++) {
+        run_nested_suite(&T_shuffled_suite, options[run]);
+        shuffled_markers(order, "<test ");
+        assert_that(strstr(order, "12") || strstr(order, "21"));
+      }
+    });
+
+    it("runs `before` and `after` on the way to every test", {
+      const char *options[] = {"CSPEC_ORDER=random", "CSPEC_SEED=7", NULL};
+      run_nested_suite(&T_shuffled_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested_count("<module 1>") equals to 4);
+      assert_that_int(nested_count("<after>") equals to 4);
+      assert_that_int(nested_count("<alpha>") equals to 2);
+      assert_that_int(nested_count("<after alpha>") equals to 2);
+      assert_that_int(nested_count("`alpha`") equals to 1);
+      assert_that_int(nested_count("T_shuffled_first") equals to 1);
+    });
+
+    it("shuffles the tests the same way inside of a forked worker", {
+      const char *options[] = {"CSPEC_ORDER=random", "CSPEC_SEED=7", NULL};
+      const char *jobs[]    = {
+        "CSPEC_ORDER=random", "CSPEC_SEED=7", "CSPEC_JOBS=2", NULL
+      };
+
+      run_nested_suite(&T_shuffled_suite, options);
+      shuffled_markers(order, "<test ");
+      run_nested_suite(&T_shuffled_suite, jobs);
+      shuffled_markers(replayed, "<test ");
+      assert_that_int(nested.counters.tests equals to 7);
+      assert_that_charptr(replayed equals to order);
+    });
+  });
+})
+
+#endif
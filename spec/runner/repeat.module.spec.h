@@ -0,0 +1,52 @@
+#ifndef __REPEAT_MODULE_SPEC_H_
+#define __REPEAT_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+static int repeated_runs = 0;
+
+module(T_flaky_suite, {
+  it("fails on its third run", {
+    repeated_runs++;
+    assert_that(repeated_runs isnot 3);
+  });
+  it("always passes", { printf("<steady test>\n"); });
+})
+
+module(T_repeat, {
+  describe("running the suite more than once", {
+    it("runs the suite CSPEC_REPEAT times and sums up every test", {
+      const char *options[] = {"CSPEC_REPEAT=4", NULL};
+      run_nested_suite(&T_flaky_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.tests equals to 8);
+      assert_that_int(nested.counters.passing equals to 7);
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that_int(nested_count("<steady test>") equals to 4);
+    });
+
+    it("stops after the run a test failed in with CSPEC_UNTIL_FAILURE", {
+      const char *options[] = {"CSPEC_UNTIL_FAILURE=1", NULL};
+      run_nested_suite(&T_flaky_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.tests equals to 6);
+      assert_that_int(nested_count("<steady test>") equals to 3);
+    });
+
+    it("stops after CSPEC_REPEAT runs when no test fails", {
+      const char *options[] = {
+        "CSPEC_UNTIL_FAILURE=1", "CSPEC_REPEAT=2", NULL
+      };
+      run_nested_suite(&T_flaky_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested.counters.tests equals to 4);
+      assert_that_int(nested.counters.failing equals to 0);
+    });
+  });
+})
+
+#endif
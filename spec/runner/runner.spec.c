@@ -0,0 +1,64 @@
+/* The specs of the runner itself. Unlike the examples, every test here is
+ * meant to pass: each one starts a suite of its own in a forked child and
+ * checks the counters and exit status it ends with.
+ *
+ * Build with: cc spec/runner/runner.spec.c -o runner.spec */
+#include "../../src/cSpec.h"
+
+#if defined(CSPEC_HAS_FORK)
+
+  #include "./arena.module.spec.h"
+  #include "./arguments.module.spec.h"
+  #include "./discovery.module.spec.h"
+  #include "./filter.module.spec.h"
+  #include "./fork_server.module.spec.h"
+  #include "./isolation.module.spec.h"
+  #include "./jobs.module.spec.h"
+  #include "./journal.module.spec.h"
+  #include "./max_failures.module.spec.h"
+  #include "./random_order.module.spec.h"
+  #include "./repeat.module.spec.h"
+  #include "./schedule.module.spec.h"
+  #include "./shard.module.spec.h"
+  #include "./tags.module.spec.h"
+  #include "./threads.module.spec.h"
+
+  #if defined(CSPEC_HAS_SIGNALS)
+    #include "./crashes.module.spec.h"
+    #include "./timeout.module.spec.h"
+  #endif
+
+static void runner_specs(void) {
+  T_arena();
+  T_discovery();
+  T_jobs();
+  T_threads();
+  T_schedule();
+  T_shard();
+  T_max_failures();
+  #if defined(CSPEC_HAS_SIGNALS)
+  T_timeout();
+  T_crashes();
+  #endif
+  T_isolation();
+  T_fork_server();
+  T_journal();
+  T_random_order();
+  T_repeat();
+  T_filter();
+  T_tags();
+  T_arguments();
+}
+
+int main(int argc, char **argv) {
+  cspec_run_suite_argv(argc, argv, { runner_specs(); });
+}
+
+#else
+
+int main(void) {
+  printf("The specs of the runner fork nested suites, which needs POSIX\n");
+  return EXIT_SUCCESS;
+}
+
+#endif
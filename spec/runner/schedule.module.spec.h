@@ -0,0 +1,108 @@
+#ifndef __SCHEDULE_MODULE_SPEC_H_
+#define __SCHEDULE_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+static CSPEC_THREAD_LOCAL char schedule_log[64];
+static CSPEC_THREAD_LOCAL char history[64];
+static CSPEC_THREAD_LOCAL char history_option[80];
+
+/* Named in the body, which is where isolated tests have a process */
+static void schedule_files(void) {
+  nested_file(history, sizeof(history), "history");
+  nested_file(schedule_log, sizeof(schedule_log), "schedule");
+  snprintf(
+    history_option, sizeof(history_option), "CSPEC_HISTORY=%s", history
+  );
+}
+
+/* Every module notes when its worker starts it */
+static void schedule_start(const char *module_name) {
+  FILE *log = fopen(schedule_log, "a");
+
+  if(log != NULL) {
+    fprintf(log, "%s\n", module_name);
+    fclose(log);
+  }
+}
+
+static void schedule_spin(size_t milliseconds) {
+  size_t start = cspec_timer();
+  while(cspec_timer() - start < milliseconds * 1000000) {}
+}
+
+module(T_quick_module, {
+  before({ schedule_start("quick"); });
+  it("takes no time", { assert_that(1 is 1); });
+})
+
+module(T_slow_module, {
+  before({ schedule_start("slow"); });
+  it("takes a while", { schedule_spin(60); });
+})
+
+module(T_slower_module, {
+  before({ schedule_start("slower"); });
+  it("takes longer", { schedule_spin(90); });
+})
+
+static void T_weighed_suite(void) {
+  T_quick_module();
+  T_slow_module();
+  T_slower_module();
+}
+
+module(T_schedule, {
+  describe("scheduling modules by their history", {
+    char contents[1024];
+
+    it("records the duration and path of every test", {
+      const char *options[] = {history_option, NULL};
+      schedule_files();
+      run_nested_suite(&T_weighed_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(
+        nested_read_file(history, contents, sizeof(contents)) equals to 3
+      );
+      assert_that(strstr(contents, " T_slower_module/takes longer\n"));
+      assert_that(strstr(contents, "schedule.module.spec.h:"));
+      remove(history);
+      remove(schedule_log);
+    });
+
+    it("starts the longest modules first once their durations are known", {
+      const char *options[] = {"CSPEC_JOBS=2", history_option, NULL};
+      schedule_files();
+      run_nested_suite(&T_weighed_suite, options);
+      remove(schedule_log);
+      run_nested_suite(&T_weighed_suite, options);
+
+      assert_that_int(nested.counters.passing equals to 3);
+      assert_that_int(
+        nested_read_file(schedule_log, contents, sizeof(contents)) equals to 3
+      );
+      assert_that_charptr(contents + strlen(contents) - 6 equals to "quick\n");
+      remove(history);
+      remove(schedule_log);
+    });
+
+    it("keeps the durations of the tests that did not run", {
+      const char *options[]  = {history_option, NULL};
+      const char *filtered[] = {history_option, "CSPEC_ID=0", NULL};
+      schedule_files();
+      run_nested_suite(&T_weighed_suite, options);
+      run_nested_suite(&T_weighed_suite, filtered);
+
+      assert_that_int(nested.counters.tests equals to 1);
+      assert_that_int(
+        nested_read_file(history, contents, sizeof(contents)) equals to 3
+      );
+      remove(history);
+      remove(schedule_log);
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef __SHARD_MODULE_SPEC_H_
+#define __SHARD_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+#include "./schedule.module.spec.h"
+
+module(T_sharded_suite, {
+  describe("alpha", {
+    it("runs test 1", { printf("<test 1>\n"); });
+    it("runs test 2", { printf("<test 2>\n"); });
+    it("runs test 3", { printf("<test 3>\n"); });
+  });
+  describe("beta", {
+    it("runs test 4", { printf("<test 4>\n"); });
+    it("runs test 5", { printf("<test 5>\n"); });
+    context("gamma", {
+      it("runs test 6", { printf("<test 6>\n"); });
+      it("runs test 7", { printf("<test 7>\n"); });
+      it("runs test 8", { printf("<test 8>\n"); });
+    });
+  });
+})
+
+/**
+ * @brief Counts how often the last nested suite ran each of the 8 tests
+ * @param runs -> Gets added the runs of every test
+ */
+static void shard_count_runs(size_t runs[8]) {
+  size_t test;
+
+  for(test = 0; test < 8; test++) {
+    char marker[16];
+    snprintf(marker, sizeof(marker), "<test %zu>", test + 1);
+    runs[test] += nested_count(marker);
+  }
+}
+
+module(T_shard, {
+  describe("splitting the suite into shards", {
+    it("runs every test in exactly one of the shards", {
+      const char *shards[][3] = {
+        {"CSPEC_SHARD_COUNT=3", "CSPEC_SHARD_INDEX=0", NULL},
+        {"CSPEC_SHARD_COUNT=3", "CSPEC_SHARD_INDEX=1", NULL},
+        {"CSPEC_SHARD_COUNT=3", "CSPEC_SHARD_INDEX=2", NULL},
+      };
+      size_t runs[8] = {0};
+      size_t tests   = 0;
+      size_t shard;
+      size_t test;
+
+      for(shard = 0; shard < 3; shard++) {
+        run_nested_suite(&T_sharded_suite, shards[shard]);
+        shard_count_runs(runs);
+        tests += nested.counters.tests;
+      }
+      assert_that_int(tests equals to 8);
+      for(test = 0; test < 8; test++) {
+        assert_that_int(runs[test] equals to 1);
+      }
+    });
+
+    it("deals the same tests to a shard every time", {
+      const char *options[] = {
+        "CSPEC_SHARD_COUNT=2", "CSPEC_SHARD_INDEX=1", NULL
+      };
+      size_t first[8]  = {0};
+      size_t second[8] = {0};
+      size_t test;
+
+      run_nested_suite(&T_sharded_suite, options);
+      shard_count_runs(first);
+      run_nested_suite(&T_sharded_suite, options);
+      shard_count_runs(second);
+      for(test = 0; test < 8; test++) {
+        assert_that_int(second[test] equals to first[test]);
+      }
+    });
+
+    it("balances the shards by the durations in the history", {
+      const char *shards[][4] = {
+        {history_option,
+         "CSPEC_SHARD_BALANCE=1",
+         "CSPEC_SHARD_COUNT=2",
+         "CSPEC_SHARD_INDEX=0"},
+        {history_option,
+         "CSPEC_SHARD_BALANCE=1",
+         "CSPEC_SHARD_COUNT=2",
+         "CSPEC_SHARD_INDEX=1"},
+      };
+      const char *with_history[] = {history_option, NULL};
+      const char *first[]        = {
+        shards[0][0], shards[0][1], shards[0][2], shards[0][3], NULL
+      };
+      const char *second[] = {
+        shards[1][0], shards[1][1], shards[1][2], shards[1][3], NULL
+      };
+
+      schedule_files();
+      run_nested_suite(&T_weighed_suite, with_history);
+      run_nested_suite(&T_weighed_suite, first);
+      assert_that_int(nested.counters.tests equals to 1);
+      run_nested_suite(&T_weighed_suite, second);
+      assert_that_int(nested.counters.tests equals to 2);
+      remove(history);
+      remove(schedule_log);
+    });
+
+    it("refuses an index that is not below the count", {
+      const char *outside[] = {
+        "CSPEC_SHARD_COUNT=2", "CSPEC_SHARD_INDEX=2", NULL
+      };
+      const char *empty[] = {"CSPEC_SHARD_COUNT=0", NULL};
+
+      run_nested_suite(&T_sharded_suite, outside);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      assert_that(!nested_printed("<test"));
+      run_nested_suite(&T_sharded_suite, empty);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef __TAGS_MODULE_SPEC_H_
+#define __TAGS_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+module(T_tagged_suite, {
+  describe_tagged("file store", ":io", {
+    it_tagged("reloads a large index", ":slow", {
+      printf("<io slow test>\n");
+    });
+    it_tagged("reads a record", ":fast", { printf("<io fast test>\n"); });
+  });
+  context_tagged("in memory", "fast", {
+    it("looks a key up", { printf("<memory test>\n"); });
+  });
+  it("has no tags", { printf("<untagged test>\n"); });
+})
+
+module(T_tags, {
+  describe("running the tests whose tags match an expression", {
+    it("picks the tests with a tag, also from their blocks", {
+      const char *options[] = {"CSPEC_TAGS=fast", NULL};
+      run_nested_suite(&T_tagged_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_SUCCESS);
+      assert_that_int(nested.counters.tests equals to 2);
+      assert_that(nested_printed("<io fast test>"));
+      assert_that(nested_printed("<memory test>"));
+    });
+
+    it("runs untagged tests for a negation", {
+      const char *options[] = {"CSPEC_TAGS=!io", NULL};
+      run_nested_suite(&T_tagged_suite, options);
+
+      assert_that_int(nested.counters.tests equals to 2);
+      assert_that(nested_printed("<untagged test>"));
+      assert_that(!nested_printed("<io "));
+    });
+
+    it("combines tags with `&`, `|` and parentheses", {
+      const char *both[]   = {"CSPEC_TAGS=io & !slow", NULL};
+      const char *either[] = {"CSPEC_TAGS=(slow | !io) & !fast", NULL};
+
+      run_nested_suite(&T_tagged_suite, both);
+      assert_that_int(nested.counters.tests equals to 1);
+      assert_that(nested_printed("<io fast test>"));
+
+      run_nested_suite(&T_tagged_suite, either);
+      assert_that_int(nested.counters.tests equals to 2);
+      assert_that(nested_printed("<io slow test>"));
+      assert_that(nested_printed("<untagged test>"));
+    });
+
+    it("refuses an expression it cannot read", {
+      const char *trailing[] = {"CSPEC_TAGS=fast &", NULL};
+      const char *unclosed[] = {"CSPEC_TAGS=(fast", NULL};
+
+      run_nested_suite(&T_tagged_suite, trailing);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      assert_that(!nested_printed("<"));
+      run_nested_suite(&T_tagged_suite, unclosed);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+    });
+
+    it("refuses a tag that no block declares", {
+      const char *typo[]    = {"CSPEC_TAGS=fsat", NULL};
+      const char *negated[] = {"CSPEC_TAGS=fast & !nett", NULL};
+
+      run_nested_suite(&T_tagged_suite, typo);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      assert_that(nested_printed("`fsat`"));
+      assert_that(!nested_printed("<"));
+      run_nested_suite(&T_tagged_suite, negated);
+      assert_that_int(nested.status equals to CSPEC_EXIT_USAGE);
+      assert_that(nested_printed("`nett`"));
+      assert_that(!nested_printed("<"));
+    });
+
+    it("lists every block and test with its own tags", {
+      const char *options[] = {"CSPEC_LIST=1", NULL};
+      run_nested_suite(&T_tagged_suite, options);
+
+      assert_that_int(nested_count(" :io") equals to 1);
+      assert_that_int(nested_count(" :slow") equals to 1);
+      assert_that_int(nested_count(" :fast") equals to 2);
+      assert_that(!nested_printed("<"));
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef __THREADS_MODULE_SPEC_H_
+#define __THREADS_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./arena.module.spec.h"
+#include "./jobs.module.spec.h"
+#include "./nested_suite.spec.h"
+
+/* The suite and both threads start out with a chunk of their own */
+#if defined(CSPEC_THREAD_POOL)
+  #define POOLED_CHUNKS 3
+#else
+  #define POOLED_CHUNKS 1
+#endif
+
+/* Without CSPEC_THREAD_POOL the same suite runs on the main thread */
+module(T_threads, {
+  describe("spreading modules over a pool of threads", {
+    it("keeps the results of every thread apart until the report", {
+      const char *options[] = {"CSPEC_THREADS=2", NULL};
+      run_nested_suite(&T_split_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.tests equals to 4);
+      assert_that_int(nested.counters.passing equals to 3);
+      assert_that_int(nested.counters.failing equals to 1);
+    });
+
+    it("prints the modules in the order they were discovered", {
+      const char *options[] = {"CSPEC_THREADS=2", NULL};
+      run_nested_suite(&T_split_suite, options);
+
+      assert_that(nested_printed("<first module>"));
+      assert_that(
+        strstr(nested.output, "<first module>") <
+        strstr(nested.output, "<second module>")
+      );
+    });
+
+    it("reports the mallocs of every thread", {
+      const char *options[] = {"CSPEC_THREADS=2", NULL};
+      run_nested_suite(&T_split_suite, options);
+
+      assert_that(nested_number(" bytes in ") >= POOLED_CHUNKS);
+    });
+  });
+})
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef __TIMEOUT_MODULE_SPEC_H_
+#define __TIMEOUT_MODULE_SPEC_H_
+
+#include "../../src/cSpec.h"
+#include "./nested_suite.spec.h"
+
+static volatile int hanging = 1;
+static int changed_before_the_hang = 0;
+
+module(T_hanging_suite, {
+  it("hangs", {
+    while(hanging) {}
+  });
+  it("passes after the hang", { printf("<after the hang>\n"); });
+})
+
+module(T_changing_suite, {
+  it("changes a global and hangs", {
+    changed_before_the_hang = 1;
+    while(hanging) {}
+  });
+  it("does not see the change", {
+    assert_that_int(changed_before_the_hang equals to 0);
+  });
+})
+
+module(T_limited_suite, {
+  timeout_each(30);
+  it("hangs past its own limit", {
+    while(hanging) {}
+  });
+})
+
+module(T_timeout, {
+  describe("failing tests that run out of time", {
+    it("fails a test that takes longer than CSPEC_TIMEOUT", {
+      const char *options[] = {"CSPEC_TIMEOUT=50", NULL};
+      run_nested_suite(&T_hanging_suite, options);
+
+      assert_that_int(nested.status equals to EXIT_FAILURE);
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that(nested_printed("timed out after 50 ms"));
+    });
+
+    it("goes on with the next test", {
+      const char *options[] = {"CSPEC_TIMEOUT=50", NULL};
+      run_nested_suite(&T_hanging_suite, options);
+
+      assert_that_int(nested.counters.passing equals to 1);
+      assert_that(nested_printed("<after the hang>"));
+    });
+
+    it("keeps the changes of a timed out test in its child", {
+      const char *options[] = {"CSPEC_TIMEOUT=50", NULL};
+      run_nested_suite(&T_changing_suite, options);
+
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that_int(nested.counters.passing equals to 1);
+    });
+
+    it("takes the limit of `timeout_each` over the default", {
+      const char *options[] = {"CSPEC_TIMEOUT=5000", NULL};
+      size_t start = cspec_timer();
+      run_nested_suite(&T_limited_suite, options);
+
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that(nested_printed("timed out after 30 ms"));
+      assert_that(cspec_timer() - start < 2000 * 1000000);
+    });
+
+    it("times tests out when more threads are asked for", {
+      const char *options[] = {"CSPEC_TIMEOUT=50", "CSPEC_THREADS=2", NULL};
+      run_nested_suite(&T_hanging_suite, options);
+
+      assert_that_int(nested.counters.failing equals to 1);
+      assert_that(nested_printed("<after the hang>"));
+    });
+  });
+})
+
+#endif
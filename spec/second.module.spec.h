@@ -62,6 +62,27 @@ module(T_second, {
       nassert_that_double_array(my_arr2 equals to bb with array_size 5);
     });
 
+    it("succeeds `assert_that_int_array` on long arrays", {
+      int actual[1000];
+      int expected[1000];
+      for(int i = 0; i < 1000; i++) {
+        actual[i]   = i;
+        expected[i] = i;
+      }
+      assert_that_int_array(actual equals to expected with array_size 1000);
+    });
+    it("fails `assert_that_int_array` on long arrays with a window", {
+      int actual[1000];
+      int expected[1000];
+      for(int i = 0; i < 1000; i++) {
+        actual[i]   = i;
+        expected[i] = i;
+      }
+      actual[500] = -1;
+      actual[700] = -1;
+      assert_that_int_array(actual equals to expected with array_size 1000);
+    });
+
     it("succeeds `assert_that_charptr_array`", {
       char *my_arr[5] = {
         (char *)"a", (char *)"b", (char *)"c", (char *)"d", (char *)"e"
@@ -3,6 +3,7 @@
 
 #include "../src/cSpec.h"
 
+#include <math.h>
 #include <stdio.h>
 
 static void debug_msg(void) { printf("This is called before all tests\n"); }
@@ -412,6 +413,141 @@ module(T_simple, {
       nassert_that_double_array(actual equals to expected with array_size 3);
     });
 
+    it("succeeds `assert_that_float_array_within`", {
+      float actual[5]   = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+      float expected[5] = {1.0f, 2.0f, 3.0f, 4.0f, 5.001f};
+      assert_that_float_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_absolute_tolerance(0.01)
+      );
+    });
+    it("fails `assert_that_float_array_within`", {
+      float actual[5]   = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+      float expected[5] = {1.0f, 2.5f, 3.0f, 4.0f, 5.5f};
+      assert_that_float_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_absolute_tolerance(0.01)
+      );
+    });
+
+    it("succeeds `nassert_that_float_array_within`", {
+      float actual[5]   = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+      float expected[5] = {1.0f, 2.5f, 3.0f, 4.0f, 5.0f};
+      nassert_that_float_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_ulp_tolerance(4)
+      );
+    });
+    it("fails `nassert_that_float_array_within`", {
+      float actual[5]   = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+      float expected[5] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+      nassert_that_float_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_ulp_tolerance(4)
+      );
+    });
+
+    it("succeeds `nassert_that_float_array_within` past the vector lanes", {
+      float actual[5]   = {0.0f, 0.0f, 0.0f, 0.0f, 0.1f};
+      float expected[5] = {0.1f, 0.1f, 0.1f, 0.1f, 0.1f};
+      nassert_that_float_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_absolute_tolerance(0.1)
+      );
+    });
+    it("fails `assert_that_float_array_within` past the vector lanes", {
+      float actual[5]   = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+      float expected[5] = {0.1f, 0.1f, 0.1f, 0.1f, 0.1f};
+      assert_that_float_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_absolute_tolerance(0.1)
+      );
+    });
+
+    it("succeeds `assert_that_double_array_within`", {
+      double actual[5]   = {1e10, 2e10, 3e10, 4e10, 5e10};
+      double expected[5] = {1e10 + 1, 2e10, 3e10, 4e10, 5e10 - 1};
+      assert_that_double_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_relative_tolerance(1e-9)
+      );
+    });
+    it("fails `assert_that_double_array_within`", {
+      double actual[5]   = {1e10, 2e10, 3e10, 4e10, 5e10};
+      double expected[5] = {1e10, 2e10, 3e10 + 1e5, 4e10, 5e10};
+      assert_that_double_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_relative_tolerance(1e-9)
+      );
+    });
+
+    it("succeeds `assert_that_double_array_within` on infinities", {
+      double actual[5]   = {INFINITY, -INFINITY, 1.0, 2.0, INFINITY};
+      double expected[5] = {INFINITY, -INFINITY, 1.0, 2.0, INFINITY};
+      assert_that_double_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_relative_tolerance(1e-9)
+      );
+    });
+    it("succeeds `assert_that_float_array_within` on infinities", {
+      float actual[5]   = {INFINITY, 1.0f, -INFINITY, 2.0f, INFINITY};
+      float expected[5] = {INFINITY, 1.0f, -INFINITY, 2.0f, INFINITY};
+      assert_that_float_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_absolute_tolerance(0)
+      );
+    });
+
+    it("succeeds `nassert_that_double_array_within` on an infinity", {
+      double actual[2]   = {INFINITY, 1.0};
+      double expected[2] = {1.0, 1.0};
+      nassert_that_double_array_within(
+        actual equals to expected with array_size 2 within
+          cspec_relative_tolerance(0.5)
+      );
+    });
+    it("succeeds `nassert_that_float_array_within` on an infinity", {
+      float actual[1]   = {INFINITY};
+      float expected[1] = {1.0f};
+      nassert_that_float_array_within(
+        actual equals to expected with array_size 1 within
+          cspec_relative_tolerance(0.5)
+      );
+    });
+    it("succeeds `nassert_that_double_array_within` on opposite infinities", {
+      double actual[1]   = {-INFINITY};
+      double expected[1] = {INFINITY};
+      nassert_that_double_array_within(
+        actual equals to expected with array_size 1 within
+          cspec_relative_tolerance(0.5)
+      );
+    });
+    it("succeeds `nassert_that_float_array_within` on opposite infinities", {
+      float actual[4]   = {1.0f, -INFINITY, 2.0f, 3.0f};
+      float expected[4] = {1.0f, INFINITY, 2.0f, 3.0f};
+      nassert_that_float_array_within(
+        actual equals to expected with array_size 4 within
+          cspec_relative_tolerance(0.5)
+      );
+    });
+
+    it("succeeds `nassert_that_double_array_within`", {
+      double actual[5]   = {0.1, 0.2, 0.3, 0.4, 0.5};
+      double expected[5] = {0.1, 0.2, 0.3, 0.4, 0.6};
+      nassert_that_double_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_ulp_tolerance(2)
+      );
+    });
+    it("fails `nassert_that_double_array_within`", {
+      double actual[5]   = {0.1, 0.2, 0.1 + 0.2, 0.4, 0.5};
+      double expected[5] = {0.1, 0.2, 0.3, 0.4, 0.5};
+      nassert_that_double_array_within(
+        actual equals to expected with array_size 5 within
+          cspec_ulp_tolerance(2)
+      );
+    });
+
     it("succeeds `assert_that_int`", { assert_that_int(1 equals to 1); });
     it("fails `assert_that_int`", { assert_that_int(2 equals to 3); });
 
@@ -448,6 +584,31 @@ module(T_simple, {
       nassert_that_charptr("ok str" equals to "ok str");
     });
 
+    it("succeeds `assert_that_charptr_n`", {
+      assert_that_charptr_n("ab\0cd" equals to "ab\0cd" with array_size 5);
+    });
+    it("fails `assert_that_charptr_n`", {
+      assert_that_charptr_n("ab\0cd" equals to "ab\0ce" with array_size 5);
+    });
+
+    it("succeeds `nassert_that_charptr_n`", {
+      nassert_that_charptr_n("ab\0cd" equals to "ab\0ce" with array_size 5);
+    });
+    it("fails `nassert_that_charptr_n`", {
+      nassert_that_charptr_n("ab\0cd" equals to "ab\0cd" with array_size 5);
+    });
+
+    it("fails `assert_that_charptr` with an excerpt of long strings", {
+      assert_that_charptr(
+        "a long serialized message with a payload that goes on and on "
+        "until the first difference shows up right here: 1, and then "
+        "continues past the end of the rendered window" equals to
+          "a long serialized message with a payload that goes on and on "
+          "until the first difference shows up right here: 2, and then "
+          "continues past the end of the rendered window"
+      );
+    });
+
     it("succeeds `assert_that_charptr_array`", {
       char *actual[3]   = {(char *)"str1", (char *)"str2", (char *)"str3"};
       char *expected[3] = {(char *)"str1", (char *)"str2", (char *)"str3"};